@@ -1,4 +1,7 @@
 #pragma once
+#include "daemon.h"
+#include "filewatcher.h"
+#include "tagexpression.h"
 #include "utils.h"
 #include <cmdlime/config.h>
 #include <cmdlime/postprocessor.h>
@@ -44,6 +47,21 @@ struct CommandSaveContents : public cmdlime::Config{
     CMDLIME_ARG(testPath, std::filesystem::path)               << "test directory" << EnsureDirectoryExists{};
 };
 
+struct CommandMergeResults : public cmdlime::Config{
+    CMDLIME_ARGLIST(resultFiles, std::vector<std::filesystem::path>) << "files with results of sharded test runs";
+    CMDLIME_PARAM(listFailedTests, std::filesystem::path)()          << "write a list of failed tests to the specified file";
+    CMDLIME_PARAM(testDurations, std::filesystem::path)()            << "update the specified file with recorded test durations";
+    CMDLIME_PARAM(reportWidth, int)(48)                              << "set the test report's width as the number of characters";
+    CMDLIME_PARAM(reportFile, std::filesystem::path)()               << "write the test report to the specified file";
+};
+
+struct CommandClient : public cmdlime::Config{
+    CMDLIME_ARG(socket, std::filesystem::path)                       << "socket of the running lunchtoast daemon";
+    CMDLIME_ARGLIST(testPaths, std::vector<std::filesystem::path>)() << "tests or test directories to run, all tests are run if not specified";
+    CMDLIME_PARAMLIST(select, std::vector<std::string>)()            << "select tests by tag names" << EnsureContainsUniqueElements{};
+    CMDLIME_PARAMLIST(skip, std::vector<std::string>)()              << "skip tests by tag names" << EnsureContainsUniqueElements{};
+};
+
 struct CommandLine : public cmdlime::Config{
     CMDLIME_ARG(testPath, std::filesystem::path)               << "directory containing tests" << EnsureDirectoryExists{};
     CMDLIME_PARAM(config, std::filesystem::path)()             << "config file for setting variables and actions";
@@ -52,11 +70,31 @@ struct CommandLine : public cmdlime::Config{
     CMDLIME_PARAM(collectFailedTests, std::filesystem::path)() << "copy directories containing failed tests to the specified path";
     CMDLIME_PARAMLIST(select, std::vector<std::string>)()      << "select tests by tag names" << EnsureContainsUniqueElements{};
     CMDLIME_PARAMLIST(skip, std::vector<std::string>)()        << "skip tests by tag names" << EnsureContainsUniqueElements{};
+    CMDLIME_PARAM(tagExpression, std::string)()                << "select tests by a boolean expression of tag names";
+    CMDLIME_PARAM(tagIndex, std::filesystem::path)()           << "read and update the index of test tags used for selecting tests";
+    CMDLIME_PARAM(testPlan, std::filesystem::path)()           << "store collected tests in the specified file and reuse them while test files are unchanged";
     CMDLIME_FLAG(withoutCleanup)                               << "disable cleanup of test files";
     CMDLIME_PARAM(reportWidth, int)(48)                        << "set the test report's width as the number of characters";
     CMDLIME_PARAM(reportFile, std::filesystem::path)()         << "write the test report to the specified file";
     CMDLIME_PARAM(searchDepth, cmdlime::optional<int>)         << "the number of descents into child directories levels for tests searching";
+    CMDLIME_PARAM(maxFailures, cmdlime::optional<int>)         << "stop testing after the specified number of failed tests";
+    CMDLIME_FLAG(failFast)                                     << "stop testing after the first failed test";
+    CMDLIME_PARAM(shardIndex, cmdlime::optional<int>)          << "run only tests of the specified shard (starting with 0)";
+    CMDLIME_PARAM(shardCount, cmdlime::optional<int>)          << "split tests into the specified number of shards";
+    CMDLIME_PARAM(testDurations, std::filesystem::path)()      << "read and update test durations used for balancing shards";
+    CMDLIME_PARAM(saveResults, std::filesystem::path)()        << "write test results for the mergeResults command";
+    CMDLIME_PARAM(scratchDir, std::filesystem::path)()         << "run tests in temporary copies of their directories created in the specified path";
+    CMDLIME_FLAG(updateBaselines)                              << "rewrite performance baseline files of launched processes";
+    CMDLIME_PARAM(repeat, cmdlime::optional<int>)              << "run each test the specified number of times";
+    CMDLIME_FLAG(untilFail)                                    << "repeat each test until it fails";
+    CMDLIME_FLAG(watch)                                        << "rerun tests affected by changes of their files until interrupted";
+    CMDLIME_FLAG(showProgress)                                 << "show a status line with the testing progress in the terminal";
+    CMDLIME_PARAM(daemonSocket, std::filesystem::path)()       << "keep running and launch tests requested by the client command on the specified socket";
+    CMDLIME_PARAM(jobs, int)(1)                                << "the number of tests launched in parallel";
+    CMDLIME_PARAM(dataCacheDir, std::filesystem::path)()       << "store data of Generate sections in the specified directory";
     CMDLIME_COMMAND(saveContents, CommandSaveContents)         << "save the current contents of the test directory";
+    CMDLIME_COMMAND(mergeResults, CommandMergeResults)         << "merge results of sharded test runs";
+    CMDLIME_COMMAND(client, CommandClient)                     << "run tests on the daemon started with the daemonSocket parameter";
 };
 // clang-format on
 
@@ -73,9 +111,67 @@ struct PostProcessor<lunchtoast::CommandLine> {
             cfg.saveContents->testPath = fs::absolute(cfg.saveContents->testPath);
             return;
         }
+        if (cfg.mergeResults.has_value())
+            return;
+        if (cfg.client.has_value()) {
+            if (!lunchtoast::Daemon::isSupported())
+                throw cmdlime::ValidationError{"client command isn't supported on this platform"};
+            // The daemon can be started from another directory, so it receives absolute test paths
+            for (auto& testPath : cfg.client->testPaths)
+                testPath = fs::weakly_canonical(fs::absolute(testPath));
+            return;
+        }
+
+        if (cfg.maxFailures.has_value() && cfg.maxFailures.value() <= 0)
+            throw cmdlime::ValidationError{"maxFailures parameter value must be a positive number"};
+
+        if (cfg.repeat.has_value() && cfg.repeat.value() <= 0)
+            throw cmdlime::ValidationError{"repeat parameter value must be a positive number"};
+
+        if (cfg.jobs <= 0)
+            throw cmdlime::ValidationError{"jobs parameter value must be a positive number"};
+
+        if (!cfg.tagExpression.empty()) {
+            try {
+                auto tagExpression = lunchtoast::TagExpression{cfg.tagExpression};
+            }
+            catch (const std::runtime_error& e) {
+                throw cmdlime::ValidationError{e.what()};
+            }
+        }
+
+        if (cfg.watch && !lunchtoast::FileWatcher::isSupported())
+            throw cmdlime::ValidationError{"watch flag isn't supported on this platform"};
+        if (cfg.watch && !cfg.saveResults.empty())
+            throw cmdlime::ValidationError{"watch flag can't be used together with saveResults parameter"};
+
+        if (!cfg.daemonSocket.empty() && !lunchtoast::Daemon::isSupported())
+            throw cmdlime::ValidationError{"daemonSocket parameter isn't supported on this platform"};
+        if (!cfg.daemonSocket.empty() && cfg.watch)
+            throw cmdlime::ValidationError{"watch flag can't be used together with daemonSocket parameter"};
+
+        if (cfg.shardIndex.has_value() != cfg.shardCount.has_value())
+            throw cmdlime::ValidationError{"shardIndex and shardCount parameters must be used together"};
+        if (cfg.shardCount.has_value() && cfg.shardCount.value() <= 0)
+            throw cmdlime::ValidationError{"shardCount parameter value must be a positive number"};
+        if (cfg.shardIndex.has_value() && (cfg.shardIndex.value() < 0 || cfg.shardIndex.value() >= cfg.shardCount.value()))
+            throw cmdlime::ValidationError{"shardIndex parameter value must be in range [0, shardCount)"};
 
         cfg.testPath = fs::canonical(cfg.testPath);
 
+        if (!cfg.scratchDir.empty()) {
+            cfg.scratchDir = fs::weakly_canonical(fs::absolute(cfg.scratchDir));
+            const auto scratchDirRelativePath = cfg.scratchDir.lexically_relative(cfg.testPath);
+            if (scratchDirRelativePath.empty() || *scratchDirRelativePath.begin() != "..")
+                throw cmdlime::ValidationError{
+                        "scratchDir parameter value must be located outside of the test directory"};
+            if (cfg.updateBaselines)
+                throw cmdlime::ValidationError{"updateBaselines flag can't be used together with scratchDir parameter"};
+        }
+
+        if (!cfg.dataCacheDir.empty())
+            cfg.dataCacheDir = fs::weakly_canonical(fs::absolute(cfg.dataCacheDir));
+
         const auto path = fs::current_path();
         const auto restorePath = gsl::finally(
                 [path]
@@ -95,6 +191,21 @@ struct PostProcessor<lunchtoast::CommandLine> {
 
         if (!cfg.collectFailedTests.empty() && cfg.collectFailedTests.is_relative())
             cfg.collectFailedTests = fs::weakly_canonical(cfg.collectFailedTests);
+
+        if (!cfg.testDurations.empty() && cfg.testDurations.is_relative())
+            cfg.testDurations = fs::weakly_canonical(cfg.testDurations);
+
+        if (!cfg.saveResults.empty() && cfg.saveResults.is_relative())
+            cfg.saveResults = fs::weakly_canonical(cfg.saveResults);
+
+        if (!cfg.tagIndex.empty() && cfg.tagIndex.is_relative())
+            cfg.tagIndex = fs::weakly_canonical(cfg.tagIndex);
+
+        if (!cfg.testPlan.empty() && cfg.testPlan.is_relative())
+            cfg.testPlan = fs::weakly_canonical(cfg.testPlan);
+
+        if (!cfg.daemonSocket.empty() && cfg.daemonSocket.is_relative())
+            cfg.daemonSocket = fs::weakly_canonical(cfg.daemonSocket);
     }
 };
 } //namespace cmdlime
\ No newline at end of file
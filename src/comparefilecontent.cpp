@@ -1,9 +1,9 @@
 #include "comparefilecontent.h"
 #include "constants.h"
+#include "textdiff.h"
 #include "utils.h"
 #include <fmt/format.h>
 #include <sfun/path.h>
-#include <sfun/string_utils.h>
 #include <fstream>
 #include <utility>
 
@@ -16,12 +16,10 @@ CompareFileContent::CompareFileContent(
         fs::path workingDir,
         int actionIndex)
     : filePath_{std::move(filePath)}
-    , expectedFileContent_{std::move(expectedFileContent)}
+    , expectedFileContent_{normalizeLineEndings(std::move(expectedFileContent))}
     , workingDir_{std::move(workingDir)}
     , actionIndex_{actionIndex}
 {
-    expectedFileContent_ = sfun::replace(expectedFileContent_, "\r\n", "\n");
-    expectedFileContent_ = sfun::replace(expectedFileContent_, "\r", "\n");
 }
 
 namespace {
@@ -35,11 +33,7 @@ std::string generateComparisonFailureReport(
         std::string_view fileContent,
         std::string_view expectedFileContent)
 {
-    return fmt::format(
-            "-File: {}\n-Content:\n{}---\n-Expected content:\n{}---\n",
-            fileName,
-            fileContent.empty() ? "" : std::string{fileContent} + "\n",
-            expectedFileContent.empty() ? "" : std::string{expectedFileContent} + "\n");
+    return fmt::format("-File: {}\n", fileName) + makeTextMismatchReport("Content", fileContent, expectedFileContent);
 }
 
 } //namespace
@@ -33,6 +33,11 @@ struct TaggedVarsPreset : public figcone::Config {
     FIGCONE_DICT(vars, StringMap);
 };
 
+struct TaggedResourcesPreset : public figcone::Config {
+    FIGCONE_PARAM(tag, std::string);
+    FIGCONE_PARAM(resources, std::string);
+};
+
 struct Action : public figcone::Config {
     FIGCONE_PARAM(format, std::string);
     FIGCONE_PARAM(command, std::string);
@@ -40,12 +45,27 @@ struct Action : public figcone::Config {
     FIGCONE_PARAM(checkOutput, figcone::optional<std::string>);
     FIGCONE_PARAM(checkErrorOutput, figcone::optional<std::string>);
     FIGCONE_PARAM(stopOnFailure, bool)(true);
+    FIGCONE_PARAM(limitMemory, figcone::optional<std::string>);
+    FIGCONE_PARAM(limitCpuTime, figcone::optional<std::string>);
+    FIGCONE_PARAM(limitOpenFiles, figcone::optional<std::string>);
+    FIGCONE_PARAM(limitProcesses, figcone::optional<std::string>);
+};
+
+struct FixtureAction : public figcone::Config {
+    FIGCONE_PARAM(command, std::string);
+    FIGCONE_PARAM(detached, bool)(false);
+    FIGCONE_PARAM(checkExitCode, ExitCodeValue)(ExitCodeValue{0});
+    FIGCONE_PARAM(exportOutput, figcone::optional<std::string>);
 };
 
 struct Config : public figcone::Config {
     FIGCONE_DICT(vars, StringMap)();
     FIGCONE_NODELIST(tagVars, std::vector<TaggedVarsPreset>)();
+    FIGCONE_NODELIST(tagResources, std::vector<TaggedResourcesPreset>)();
+    FIGCONE_DICT(resourceCapacities, StringMap)();
     FIGCONE_NODELIST(actions, std::vector<Action>)();
+    FIGCONE_NODELIST(setup, std::vector<FixtureAction>)();
+    FIGCONE_NODELIST(teardown, std::vector<FixtureAction>)();
 };
 
 } //namespace lunchtoast
\ No newline at end of file
@@ -1,4 +1,5 @@
 #pragma once
+#include <chrono>
 #include <string_view>
 
 namespace lunchtoast::hardcoded {
@@ -9,5 +10,9 @@ inline constexpr auto testCaseFilename = "test.toast"sv;
 inline constexpr auto configFilename = "lunchtoast.cfg"sv;
 inline constexpr auto launchFailureReportFilename = "launch_{}.failure_info"sv;
 inline constexpr auto compareFileContentFailureReportFilename = "compare_file_content_{}.failure_info"sv;
+inline constexpr auto failureReportMaxTextSize = 64 * 1024;
+inline constexpr auto reportQueueSize = 8192;
+inline constexpr auto progressUpdateInterval = std::chrono::milliseconds{500};
+inline constexpr auto watchSettleTime = std::chrono::milliseconds{100};
 
 } //namespace lunchtoast::hardcoded
\ No newline at end of file
@@ -0,0 +1,170 @@
+#include "copydirectory.h"
+#include <gsl/util>
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <thread>
+#ifdef __linux__
+#include <fcntl.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace lunchtoast {
+namespace fs = std::filesystem;
+
+namespace {
+bool isUpToDate(const fs::path& sourceFile, const fs::path& targetFile)
+{
+    auto errorCode = std::error_code{};
+    const auto targetWriteTime = fs::last_write_time(targetFile, errorCode);
+    if (errorCode)
+        return false;
+    return targetWriteTime >= fs::last_write_time(sourceFile);
+}
+
+bool isReadOnly(const fs::path& file)
+{
+    const auto writePermissions = fs::perms::owner_write | fs::perms::group_write | fs::perms::others_write;
+    return (fs::status(file).permissions() & writePermissions) == fs::perms::none;
+}
+
+bool tryCreateHardLink(const fs::path& sourceFile, const fs::path& targetFile)
+{
+    auto errorCode = std::error_code{};
+    fs::create_hard_link(sourceFile, targetFile, errorCode);
+    return !errorCode;
+}
+
+// Copies the file with a reflink when the filesystem supports it,
+// otherwise with copy_file_range that avoids passing the data through the user space.
+bool tryCopyFileInKernel(const fs::path& sourceFile, const fs::path& targetFile)
+{
+#ifdef __linux__
+    const auto sourceFd = ::open(sourceFile.c_str(), O_RDONLY | O_CLOEXEC);
+    if (sourceFd < 0)
+        return false;
+    const auto closeSourceFd = gsl::finally(
+            [sourceFd]
+            {
+                ::close(sourceFd);
+            });
+
+    struct stat sourceStat = {};
+    if (::fstat(sourceFd, &sourceStat) != 0)
+        return false;
+
+    const auto targetFd = ::open(targetFile.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, sourceStat.st_mode & 0777);
+    if (targetFd < 0)
+        return false;
+    const auto closeTargetFd = gsl::finally(
+            [targetFd]
+            {
+                ::close(targetFd);
+            });
+
+    if (::fchmod(targetFd, sourceStat.st_mode & 07777) != 0)
+        return false;
+
+    if (::ioctl(targetFd, FICLONE, sourceFd) == 0)
+        return true;
+
+    auto bytesLeft = static_cast<std::size_t>(sourceStat.st_size);
+    while (bytesLeft > 0) {
+        const auto bytesCopied = ::copy_file_range(sourceFd, nullptr, targetFd, nullptr, bytesLeft, 0);
+        if (bytesCopied <= 0)
+            return false;
+        bytesLeft -= static_cast<std::size_t>(bytesCopied);
+    }
+    return true;
+#else
+    static_cast<void>(sourceFile);
+    static_cast<void>(targetFile);
+    return false;
+#endif
+}
+
+std::uintmax_t copyFile(const fs::path& sourceFile, const fs::path& targetFile)
+{
+    if (isUpToDate(sourceFile, targetFile))
+        return 0;
+
+    fs::remove(targetFile);
+    // Read-only files aren't supposed to be modified, so sharing them between directories is safe
+    if (isReadOnly(sourceFile) && tryCreateHardLink(sourceFile, targetFile))
+        return 0;
+
+    if (!tryCopyFileInKernel(sourceFile, targetFile))
+        fs::copy_file(sourceFile, targetFile, fs::copy_options::overwrite_existing);
+    return fs::file_size(sourceFile);
+}
+
+} //namespace
+
+std::uintmax_t copyDirectory(const fs::path& sourceDir, const fs::path& targetDir)
+{
+    auto result = std::uintmax_t{};
+    fs::create_directories(targetDir);
+    const auto end = fs::recursive_directory_iterator{};
+    for (auto it = fs::recursive_directory_iterator{sourceDir}; it != end; ++it) {
+        const auto targetPath = targetDir / it->path().lexically_relative(sourceDir);
+        // Symlinks are recreated instead of being followed, so the symlink loops and the files outside
+        // of the source directory aren't copied
+        if (fs::is_symlink(it->symlink_status())) {
+            fs::remove(targetPath);
+            fs::copy_symlink(it->path(), targetPath);
+        }
+        else if (fs::is_directory(it->status()))
+            fs::create_directories(targetPath);
+        else if (fs::is_regular_file(it->status()))
+            result += copyFile(it->path(), targetPath);
+    }
+    return result;
+}
+
+std::uintmax_t copyDirectories(const std::vector<std::pair<fs::path, fs::path>>& sourceAndTargetDirs)
+{
+    // Directories with the same target are copied sequentially by the same thread
+    auto copyTasks = std::map<fs::path, std::vector<fs::path>>{};
+    for (const auto& [sourceDir, targetDir] : sourceAndTargetDirs)
+        copyTasks[targetDir].push_back(sourceDir);
+    auto tasks = std::vector<std::pair<fs::path, std::vector<fs::path>>>{copyTasks.begin(), copyTasks.end()};
+
+    auto nextTaskIndex = std::atomic<std::size_t>{0};
+    auto bytesCopied = std::atomic<std::uintmax_t>{0};
+    auto error = std::exception_ptr{};
+    auto errorMutex = std::mutex{};
+    const auto processTasks = [&]
+    {
+        for (auto index = nextTaskIndex++; index < tasks.size(); index = nextTaskIndex++) {
+            const auto& [targetDir, sourceDirs] = tasks[index];
+            try {
+                for (const auto& sourceDir : sourceDirs)
+                    bytesCopied += copyDirectory(sourceDir, targetDir);
+            }
+            catch (...) {
+                auto lock = std::scoped_lock{errorMutex};
+                if (!error)
+                    error = std::current_exception();
+            }
+        }
+    };
+
+    const auto threadsCount = std::min<std::size_t>(std::max(std::thread::hardware_concurrency(), 1u), tasks.size());
+    auto threads = std::vector<std::thread>{};
+    for (auto i = std::size_t{1}; i < threadsCount; ++i)
+        threads.emplace_back(processTasks);
+    processTasks();
+    for (auto& thread : threads)
+        thread.join();
+
+    if (error)
+        std::rethrow_exception(error);
+    return bytesCopied;
+}
+
+} //namespace lunchtoast
@@ -0,0 +1,13 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <utility>
+#include <vector>
+
+namespace lunchtoast {
+
+std::uintmax_t copyDirectory(const std::filesystem::path& sourceDir, const std::filesystem::path& targetDir);
+std::uintmax_t copyDirectories(
+        const std::vector<std::pair<std::filesystem::path, std::filesystem::path>>& sourceAndTargetDirs);
+
+} //namespace lunchtoast
@@ -0,0 +1,222 @@
+#include "daemon.h"
+#include "testlauncher.h"
+#include "utils.h"
+#include <boost/asio.hpp>
+#include <fmt/format.h>
+#include <sfun/path.h>
+#include <array>
+#include <cstdio>
+#include <sstream>
+#include <stdexcept>
+
+namespace lunchtoast {
+namespace fs = std::filesystem;
+namespace asio = boost::asio;
+
+Daemon::Daemon(fs::path socketPath)
+    : socketPath_{std::move(socketPath)}
+{
+}
+
+void Daemon::writeOutput(std::string_view text) const
+{
+    if (clientOutput_)
+        clientOutput_(text);
+    else {
+        fmt::print("{}", text);
+        std::fflush(stdout);
+    }
+}
+
+#ifdef BOOST_ASIO_HAS_LOCAL_SOCKETS
+namespace {
+using LocalSocket = asio::local::stream_protocol::socket;
+using LocalEndpoint = asio::local::stream_protocol::endpoint;
+
+// The daemon responds with frames "<type> <size>\n<data>",
+// the report output is sent in the output frames and the test run ends with the exit code frame
+constexpr auto outputFrameType = 'o';
+constexpr auto exitCodeFrameType = 'x';
+
+void writeFrame(LocalSocket& socket, char frameType, std::string_view data, boost::system::error_code& error)
+{
+    const auto header = fmt::format("{} {}\n", frameType, data.size());
+    const auto buffers = std::array{asio::buffer(header), asio::buffer(data)};
+    asio::write(socket, buffers, error);
+}
+
+// The request is sent as lines of tab separated fields, the client closes its side of the connection after the last one
+std::string serializeRequest(const DaemonRequest& request)
+{
+    auto result = std::string{};
+    for (const auto& testPath : request.testPaths)
+        result += fmt::format("path\t{}\n", sfun::path_string(testPath));
+    for (const auto& tag : request.selectedTags)
+        result += fmt::format("select\t{}\n", tag);
+    for (const auto& tag : request.skippedTags)
+        result += fmt::format("skip\t{}\n", tag);
+    return result;
+}
+
+DaemonRequest deserializeRequest(const std::string& data)
+{
+    auto result = DaemonRequest{};
+    auto stream = std::istringstream{data};
+    auto line = std::string{};
+    while (std::getline(stream, line)) {
+        const auto fields = readTabSeparatedFields(line);
+        if (fields.size() == 2 && fields[0] == "path")
+            result.testPaths.emplace_back(sfun::make_path(fields[1]));
+        else if (fields.size() == 2 && fields[0] == "select")
+            result.selectedTags.push_back(fields[1]);
+        else if (fields.size() == 2 && fields[0] == "skip")
+            result.skippedTags.push_back(fields[1]);
+        else
+            throw std::runtime_error{fmt::format("Invalid request line: '{}'\n", line)};
+    }
+    return result;
+}
+
+asio::local::stream_protocol::acceptor makeAcceptor(asio::io_context& ioContext, const fs::path& socketPath)
+{
+    if (fs::is_socket(socketPath)) {
+        auto socket = LocalSocket{ioContext};
+        auto error = boost::system::error_code{};
+        socket.connect(LocalEndpoint{sfun::path_string(socketPath)}, error);
+        if (!error)
+            throw std::runtime_error{
+                    fmt::format("Another daemon is already running on the socket {}\n", homePathString(socketPath))};
+    }
+
+    // The socket is bound to a temporary path and moved to the specified one after it starts listening,
+    // so clients waiting for the socket file to appear don't connect before the daemon accepts connections.
+    // The socket file left by a stopped daemon is replaced at the same time.
+    auto listeningSocketPath = socketPath;
+    listeningSocketPath += ".tmp";
+    auto fsError = std::error_code{};
+    fs::remove(listeningSocketPath, fsError);
+    const auto listeningError = [&](const auto& errorCode)
+    {
+        return std::runtime_error{
+                fmt::format("Can't listen on the socket {}: {}\n", homePathString(socketPath), errorCode.message())};
+    };
+    try {
+        const auto endpoint = LocalEndpoint{sfun::path_string(listeningSocketPath)};
+        auto acceptor = asio::local::stream_protocol::acceptor{ioContext, endpoint};
+        fs::rename(listeningSocketPath, socketPath);
+        return acceptor;
+    }
+    catch (const boost::system::system_error& e) {
+        throw listeningError(e.code());
+    }
+    catch (const fs::filesystem_error& e) {
+        throw listeningError(e.code());
+    }
+}
+
+} //namespace
+
+bool Daemon::isSupported()
+{
+    return true;
+}
+
+void Daemon::serve(TestLauncher& testLauncher)
+{
+    auto ioContext = asio::io_context{};
+    auto acceptor = makeAcceptor(ioContext, socketPath_);
+    writeOutput(fmt::format(
+            "Waiting for test runs requested on the socket {}. Press Ctrl+C to stop.\n",
+            homePathString(socketPath_)));
+
+    // Requests are processed one at a time, the following clients wait for the connection in the socket's backlog
+    while (true) {
+        auto socket = acceptor.accept();
+        auto error = boost::system::error_code{};
+        auto requestData = std::string{};
+        asio::read(socket, asio::dynamic_buffer(requestData), error);
+        if (error != asio::error::eof)
+            continue;
+
+        // Testing isn't interrupted when the client disconnects, its results are still written to the specified files
+        auto isClientConnected = true;
+        clientOutput_ = [&](std::string_view text)
+        {
+            if (!isClientConnected)
+                return;
+            writeFrame(socket, outputFrameType, text, error);
+            isClientConnected = !error;
+        };
+        auto exitCode = 0;
+        try {
+            const auto request = deserializeRequest(requestData);
+            const auto allTestsPassed =
+                    testLauncher.processRequestedTests(request.testPaths, request.selectedTags, request.skippedTags);
+            exitCode = allTestsPassed ? 0 : 1;
+        }
+        catch (const std::runtime_error& e) {
+            writeOutput(e.what());
+            exitCode = 2;
+        }
+        clientOutput_ = nullptr;
+        if (isClientConnected)
+            writeFrame(socket, exitCodeFrameType, std::to_string(exitCode), error);
+    }
+}
+
+int sendDaemonRequest(const fs::path& socketPath, const DaemonRequest& request)
+{
+    auto ioContext = asio::io_context{};
+    auto socket = LocalSocket{ioContext};
+    auto error = boost::system::error_code{};
+    socket.connect(LocalEndpoint{sfun::path_string(socketPath)}, error);
+    if (error)
+        throw std::runtime_error{fmt::format(
+                "Can't connect to the daemon on the socket {}: {}\n",
+                homePathString(socketPath),
+                error.message())};
+
+    asio::write(socket, asio::buffer(serializeRequest(request)));
+    socket.shutdown(LocalSocket::shutdown_send);
+
+    auto buffer = std::string{};
+    while (true) {
+        const auto headerSize = asio::read_until(socket, asio::dynamic_buffer(buffer), '\n', error);
+        if (error || headerSize < 2)
+            break;
+        const auto header = buffer.substr(0, headerSize - 1);
+        buffer.erase(0, headerSize);
+        const auto frameSize = header.size() > 2 ? std::stoul(header.substr(2)) : 0;
+        if (buffer.size() < frameSize)
+            asio::read(socket, asio::dynamic_buffer(buffer), asio::transfer_exactly(frameSize - buffer.size()), error);
+        if (error)
+            break;
+
+        const auto data = buffer.substr(0, frameSize);
+        buffer.erase(0, frameSize);
+        if (header.front() == exitCodeFrameType)
+            return std::stoi(data);
+        fmt::print("{}", data);
+        std::fflush(stdout);
+    }
+    throw std::runtime_error{"The connection to the daemon was closed before the end of the test run\n"};
+}
+
+#else
+bool Daemon::isSupported()
+{
+    return false;
+}
+
+void Daemon::serve(TestLauncher&)
+{
+    throw std::runtime_error{"Unix domain sockets aren't supported on this platform\n"};
+}
+
+int sendDaemonRequest(const fs::path&, const DaemonRequest&)
+{
+    throw std::runtime_error{"Unix domain sockets aren't supported on this platform\n"};
+}
+#endif
+
+} //namespace lunchtoast
@@ -0,0 +1,38 @@
+#pragma once
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace lunchtoast {
+
+class TestLauncher;
+
+struct DaemonRequest {
+    std::vector<std::filesystem::path> testPaths;
+    std::vector<std::string> selectedTags;
+    std::vector<std::string> skippedTags;
+};
+
+// Serves test runs requested by clients connecting to a Unix domain socket,
+// collected tests, read config files and compiled user actions are kept between the requests
+class Daemon {
+public:
+    explicit Daemon(std::filesystem::path socketPath);
+
+    static bool isSupported();
+
+    // Report output is sent to the client of the currently processed request
+    void writeOutput(std::string_view text) const;
+    void serve(TestLauncher& testLauncher);
+
+private:
+    std::filesystem::path socketPath_;
+    std::function<void(std::string_view)> clientOutput_;
+};
+
+// Prints the report output of the requested test run and returns its exit code
+int sendDaemonRequest(const std::filesystem::path& socketPath, const DaemonRequest& request);
+
+} //namespace lunchtoast
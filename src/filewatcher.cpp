@@ -0,0 +1,140 @@
+#include "filewatcher.h"
+#include <fmt/format.h>
+#include <sfun/path.h>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace lunchtoast {
+namespace fs = std::filesystem;
+
+#ifdef __linux__
+FileWatcher::FileWatcher()
+    : fd_{inotify_init1(IN_NONBLOCK | IN_CLOEXEC)}
+{
+    if (fd_ < 0)
+        throw std::runtime_error{fmt::format("Can't initialize the file watcher: {}\n", std::strerror(errno))};
+}
+
+FileWatcher::~FileWatcher()
+{
+    ::close(fd_);
+}
+
+bool FileWatcher::isSupported()
+{
+    return true;
+}
+
+void FileWatcher::watchDirectory(const fs::path& dir)
+{
+    if (watchedDirPaths_.contains(dir))
+        return;
+    const auto mask = IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ATTRIB;
+    const auto watchDescriptor = inotify_add_watch(fd_, dir.c_str(), mask);
+    if (watchDescriptor < 0)
+        throw std::runtime_error{fmt::format(
+                "Can't watch the directory {}: {}\n",
+                sfun::path_string(dir),
+                std::strerror(errno))};
+    watchedDirs_[watchDescriptor] = dir;
+    watchedDirPaths_.insert(dir);
+}
+
+std::set<fs::path> FileWatcher::readChanges(std::chrono::milliseconds timeout)
+{
+    auto result = std::set<fs::path>{};
+    auto pollFd = pollfd{.fd = fd_, .events = POLLIN, .revents = 0};
+    const auto pollResult = ::poll(&pollFd, 1, timeout.count() < 0 ? -1 : static_cast<int>(timeout.count()));
+    if (pollResult < 0 && errno != EINTR)
+        throw std::runtime_error{fmt::format("Can't read file changes: {}\n", std::strerror(errno))};
+    if (pollResult <= 0)
+        return result;
+
+    alignas(inotify_event) auto buffer = std::array<char, 64 * 1024>{};
+    while (true) {
+        const auto size = ::read(fd_, buffer.data(), buffer.size());
+        if (size <= 0)
+            break;
+        for (auto pos = ssize_t{0}; pos < size;) {
+            const auto* event = reinterpret_cast<const inotify_event*>(buffer.data() + pos);
+            pos += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+            const auto dirIt = watchedDirs_.find(event->wd);
+            if (dirIt == watchedDirs_.end())
+                continue;
+            // The watch is removed by the system when its directory is deleted
+            if (event->mask & IN_IGNORED) {
+                watchedDirPaths_.erase(dirIt->second);
+                watchedDirs_.erase(dirIt);
+                continue;
+            }
+            if (event->len > 0)
+                result.insert(dirIt->second / event->name);
+            else
+                result.insert(dirIt->second);
+        }
+    }
+    return result;
+}
+
+#else
+FileWatcher::FileWatcher()
+{
+    throw std::runtime_error{"Watching files isn't supported on this platform\n"};
+}
+
+FileWatcher::~FileWatcher() = default;
+
+bool FileWatcher::isSupported()
+{
+    return false;
+}
+
+void FileWatcher::watchDirectory(const fs::path&)
+{
+}
+
+std::set<fs::path> FileWatcher::readChanges(std::chrono::milliseconds)
+{
+    return {};
+}
+#endif
+
+std::set<fs::path> FileWatcher::waitForChanges(std::chrono::milliseconds settleTime)
+{
+    auto result = std::set<fs::path>{};
+    while (result.empty())
+        result = readChanges(std::chrono::milliseconds{-1});
+
+    // Editors and build tools often write files in several steps, so the changes are collected until they stop
+    auto nextChanges = readChanges(settleTime);
+    while (!nextChanges.empty()) {
+        result.merge(nextChanges);
+        nextChanges = readChanges(settleTime);
+    }
+    return result;
+}
+
+std::set<fs::path> FileWatcher::pendingChanges()
+{
+    auto result = std::set<fs::path>{};
+    auto changes = readChanges(std::chrono::milliseconds{0});
+    while (!changes.empty()) {
+        result.merge(changes);
+        changes = readChanges(std::chrono::milliseconds{0});
+    }
+    return result;
+}
+
+void FileWatcher::discardChanges()
+{
+    pendingChanges();
+}
+
+} //namespace lunchtoast
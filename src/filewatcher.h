@@ -0,0 +1,35 @@
+#pragma once
+#include <chrono>
+#include <filesystem>
+#include <map>
+#include <set>
+
+namespace lunchtoast {
+
+// Watches directories for changes of their files, implemented with inotify on Linux
+class FileWatcher {
+public:
+    FileWatcher();
+    ~FileWatcher();
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    static bool isSupported();
+
+    void watchDirectory(const std::filesystem::path& dir);
+    // Blocks until files are changed, changes made within the settle time are returned together
+    std::set<std::filesystem::path> waitForChanges(std::chrono::milliseconds settleTime);
+    // Returns changes made since the previous read without blocking
+    std::set<std::filesystem::path> pendingChanges();
+    void discardChanges();
+
+private:
+    std::set<std::filesystem::path> readChanges(std::chrono::milliseconds timeout);
+
+private:
+    int fd_ = -1;
+    std::map<int, std::filesystem::path> watchedDirs_;
+    std::set<std::filesystem::path> watchedDirPaths_;
+};
+
+} //namespace lunchtoast
@@ -0,0 +1,199 @@
+#include "fixture.h"
+#include "errors.h"
+#include "launchprocess.h"
+#include "utils.h"
+#include <fmt/format.h>
+#include <range/v3/range/conversion.hpp>
+#include <range/v3/view.hpp>
+#include <sfun/path.h>
+#include <sfun/string_utils.h>
+#include <algorithm>
+#include <utility>
+
+namespace lunchtoast {
+namespace fs = std::filesystem;
+namespace views = ranges::views;
+
+namespace {
+std::vector<FixtureStep> makeFixtureSteps(const std::vector<FixtureAction>& actions)
+{
+    const auto toFixtureStep = [](const FixtureAction& action)
+    {
+        return FixtureStep{
+                .command = action.command,
+                .isDetached = action.detached,
+                .exitCode = action.checkExitCode.value,
+                .exportedVariable = action.exportOutput.has_value() ? std::optional{action.exportOutput.value()}
+                                                                    : std::nullopt};
+    };
+    return actions | views::transform(toFixtureStep) | ranges::to<std::vector>;
+}
+
+int maxPortVariableIndex(const std::vector<FixtureStep>& steps)
+{
+    auto result = 0;
+    for (const auto& step : steps)
+        result = std::max(result, maxPortVariableIndex(step.command));
+    return result;
+}
+} //namespace
+
+bool hasFixture(const Config& cfg)
+{
+    return !cfg.setup.empty() || !cfg.teardown.empty();
+}
+
+FixtureCfg makeFixtureCfg(const Config& cfg, fs::path directory, std::unordered_map<std::string, std::string> vars)
+{
+    return {.directory = std::move(directory),
+            .setup = makeFixtureSteps(cfg.setup),
+            .teardown = makeFixtureSteps(cfg.teardown),
+            .vars = std::move(vars)};
+}
+
+Fixture::Fixture(FixtureCfg cfg, std::string shellCommand)
+    : cfg_{std::move(cfg)}
+    , shellCommand_{std::move(shellCommand)}
+{
+}
+
+Fixture::~Fixture()
+{
+    tearDown();
+}
+
+void Fixture::setUp(PortAllocator& portAllocator, const std::unordered_map<std::string, std::string>& parentVars)
+{
+    if (setupError_.has_value())
+        throw TestConfigError{setupError_.value()};
+    if (isSetUp_)
+        return;
+
+    isSetUp_ = true;
+    vars_ = cfg_.vars;
+    for (const auto& [name, value] : parentVars)
+        vars_.insert_or_assign(name, value);
+    try {
+        const auto portsCount = std::max(maxPortVariableIndex(cfg_.setup), maxPortVariableIndex(cfg_.teardown));
+        if (portsCount) {
+            allocatedPorts_.emplace(portAllocator, portsCount);
+            for (auto i = 0; i < portsCount; ++i)
+                vars_[fmt::format("PORT_{}", i + 1)] = std::to_string(allocatedPorts_->ports().at(i));
+        }
+        for (const auto& step : cfg_.setup)
+            runStep(step, vars_);
+    }
+    catch (const std::exception& e) {
+        setupError_ = fmt::format("Fixture setup in {} failed: {}", homePathString(cfg_.directory), e.what());
+        throw TestConfigError{setupError_.value()};
+    }
+}
+
+void Fixture::tearDown()
+{
+    if (!isSetUp_)
+        return;
+    isSetUp_ = false;
+
+    for (const auto& step : cfg_.teardown) {
+        try {
+            runStep(step, vars_);
+        }
+        catch (const std::exception&) {
+        }
+    }
+    terminateDetachedProcesses(detachedProcessList_);
+    detachedProcessList_.clear();
+    allocatedPorts_.reset();
+}
+
+bool Fixture::isSetUp() const
+{
+    return isSetUp_;
+}
+
+const std::unordered_map<std::string, std::string>& Fixture::exportedVars() const
+{
+    return exportedVars_;
+}
+
+void Fixture::runStep(const FixtureStep& step, std::unordered_map<std::string, std::string>& vars)
+{
+    const auto command = processVariablesSubstitution(step.command, vars);
+    if (step.isDetached) {
+        auto launchProcess = LaunchProcess{command, cfg_.directory, shellCommand_, {}, 0, &detachedProcessList_};
+        launchProcess();
+        return;
+    }
+
+    const auto result = runCommand(command, shellCommand_, cfg_.directory);
+    if (step.exitCode.has_value() && result.exitCode != step.exitCode.value())
+        throw std::runtime_error{fmt::format(
+                "command '{}' returned unexpected exit code {}, error output: {}",
+                command,
+                result.exitCode,
+                sfun::trim(result.errorOutput))};
+    if (step.exportedVariable.has_value()) {
+        const auto value = std::string{sfun::trim(result.output)};
+        vars.insert_or_assign(step.exportedVariable.value(), value);
+        exportedVars_.insert_or_assign(step.exportedVariable.value(), value);
+    }
+}
+
+SuiteFixtures::SuiteFixtures(PortAllocator& portAllocator, std::string shellCommand)
+    : portAllocator_{portAllocator}
+    , shellCommand_{std::move(shellCommand)}
+{
+}
+
+SuiteFixtures::~SuiteFixtures()
+{
+    // Inner fixtures can use the services of the outer ones, so they're torn down first
+    for (const auto& configPath : setUpFixtures_ | views::reverse)
+        fixtures_.at(configPath)->tearDown();
+}
+
+void SuiteFixtures::addFixture(const fs::path& configPath, FixtureCfg cfg)
+{
+    fixtures_.emplace(configPath, std::make_unique<Fixture>(std::move(cfg), shellCommand_));
+}
+
+void SuiteFixtures::addTest(int testIndex, std::vector<fs::path> fixtureConfigPaths)
+{
+    for (const auto& configPath : fixtureConfigPaths)
+        remainingTestsCount_[configPath]++;
+    testFixtures_[testIndex] = std::move(fixtureConfigPaths);
+}
+
+std::unordered_map<std::string, std::string> SuiteFixtures::setUp(int testIndex)
+{
+    auto lock = std::scoped_lock{mutex_};
+    auto result = std::unordered_map<std::string, std::string>{};
+    const auto it = testFixtures_.find(testIndex);
+    if (it == testFixtures_.end())
+        return result;
+
+    for (const auto& configPath : it->second) {
+        auto& fixture = *fixtures_.at(configPath);
+        if (!fixture.isSetUp())
+            setUpFixtures_.push_back(configPath);
+        fixture.setUp(portAllocator_, result);
+        for (const auto& [name, value] : fixture.exportedVars())
+            result.insert_or_assign(name, value);
+    }
+    return result;
+}
+
+void SuiteFixtures::finishTest(int testIndex)
+{
+    auto lock = std::scoped_lock{mutex_};
+    const auto it = testFixtures_.find(testIndex);
+    if (it == testFixtures_.end())
+        return;
+
+    for (const auto& configPath : it->second | views::reverse)
+        if (--remainingTestsCount_.at(configPath) == 0)
+            fixtures_.at(configPath)->tearDown();
+}
+
+} //namespace lunchtoast
@@ -0,0 +1,93 @@
+#pragma once
+#include "config.h"
+#include "portallocator.h"
+#include <sfun/member.h>
+#include <boost/process/child.hpp>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace lunchtoast {
+
+struct FixtureStep {
+    std::string command;
+    bool isDetached = false;
+    std::optional<int> exitCode;
+    std::optional<std::string> exportedVariable;
+};
+
+struct FixtureCfg {
+    std::filesystem::path directory;
+    std::vector<FixtureStep> setup;
+    std::vector<FixtureStep> teardown;
+    std::unordered_map<std::string, std::string> vars;
+};
+
+bool hasFixture(const Config& cfg);
+FixtureCfg makeFixtureCfg(
+        const Config& cfg,
+        std::filesystem::path directory,
+        std::unordered_map<std::string, std::string> vars);
+
+// Setup and teardown steps of a config file, shared by all tests using this config
+class Fixture {
+public:
+    Fixture(FixtureCfg cfg, std::string shellCommand);
+    ~Fixture();
+    Fixture(const Fixture&) = delete;
+    Fixture& operator=(const Fixture&) = delete;
+
+    // Throws TestConfigError when one of the setup steps fails, the following calls throw the same error
+    void setUp(PortAllocator& portAllocator, const std::unordered_map<std::string, std::string>& parentVars);
+    // Teardown steps are run even if the setup failed, their failures are ignored
+    void tearDown();
+    bool isSetUp() const;
+    const std::unordered_map<std::string, std::string>& exportedVars() const;
+
+private:
+    void runStep(const FixtureStep& step, std::unordered_map<std::string, std::string>& vars);
+
+private:
+    FixtureCfg cfg_;
+    std::string shellCommand_;
+    bool isSetUp_ = false;
+    std::optional<std::string> setupError_;
+    std::unordered_map<std::string, std::string> vars_;
+    std::unordered_map<std::string, std::string> exportedVars_;
+    // Declared before the detached processes, so the ports are released only after these processes are terminated
+    std::optional<AllocatedPorts> allocatedPorts_;
+    std::vector<boost::process::child> detachedProcessList_;
+};
+
+// Fixtures used by the tests of a suite. A fixture is set up before the first test using it,
+// torn down after the last one, and the fixtures still running are torn down on the destruction.
+class SuiteFixtures {
+public:
+    SuiteFixtures(PortAllocator& portAllocator, std::string shellCommand);
+    ~SuiteFixtures();
+    SuiteFixtures(const SuiteFixtures&) = delete;
+    SuiteFixtures& operator=(const SuiteFixtures&) = delete;
+
+    void addFixture(const std::filesystem::path& configPath, FixtureCfg cfg);
+    // Fixtures of the test are listed from the outermost one, its exported variables are visible to the inner ones
+    void addTest(int testIndex, std::vector<std::filesystem::path> fixtureConfigPaths);
+    // Returns the variables exported by the fixtures of the test
+    std::unordered_map<std::string, std::string> setUp(int testIndex);
+    void finishTest(int testIndex);
+
+private:
+    sfun::member<PortAllocator&> portAllocator_;
+    sfun::member<const std::string> shellCommand_;
+    std::mutex mutex_;
+    std::map<std::filesystem::path, std::unique_ptr<Fixture>> fixtures_;
+    std::map<int, std::vector<std::filesystem::path>> testFixtures_;
+    std::map<std::filesystem::path, int> remainingTestsCount_;
+    std::vector<std::filesystem::path> setUpFixtures_;
+};
+
+} //namespace lunchtoast
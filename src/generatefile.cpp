@@ -0,0 +1,325 @@
+#include "generatefile.h"
+#include "errors.h"
+#include "utils.h"
+#include <fmt/format.h>
+#include <sfun/path.h>
+#include <sfun/string_utils.h>
+#include <array>
+#include <charconv>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <system_error>
+#include <utility>
+#ifdef __linux__
+#include <fcntl.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+
+namespace lunchtoast {
+namespace fs = std::filesystem;
+
+namespace {
+// Must be increased on every change of the generated data, so the files cached by previous versions aren't reused
+constexpr auto generatedDataVersion = 1;
+constexpr auto generatorChunkSize = 1024 * 1024;
+constexpr auto csvValueRange = std::uint64_t{1000000};
+
+template<typename T>
+T readSpecNumber(std::string_view paramName, std::string_view value)
+{
+    auto number = T{};
+    const auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), number);
+    if (error != std::errc{} || end != value.data() + value.size())
+        throw TestConfigError{fmt::format("Invalid generated data parameter '{}' value '{}'", paramName, value)};
+    return number;
+}
+
+std::int64_t readSpecCount(std::string_view paramName, std::string_view value)
+{
+    const auto count = readSpecNumber<std::int64_t>(paramName, value);
+    if (count < 0)
+        throw TestConfigError{fmt::format(
+                "Invalid generated data parameter '{}' value '{}', it can't be negative",
+                paramName,
+                value)};
+    return count;
+}
+
+std::string_view dataTypeName(GeneratedDataType type)
+{
+    switch (type) {
+    case GeneratedDataType::RandomBytes:
+        return "random bytes";
+    case GeneratedDataType::RepeatedLines:
+        return "repeated lines";
+    case GeneratedDataType::CsvRows:
+        return "CSV rows";
+    }
+    return {};
+}
+
+// FNV-1a is used instead of std::hash, as the data keys must be the same on every platform and build
+std::uint64_t fnv1aHash(std::string_view str)
+{
+    auto hash = std::uint64_t{14695981039346656037ull};
+    for (const auto ch : str) {
+        hash ^= static_cast<unsigned char>(ch);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+class DataWriter {
+public:
+    explicit DataWriter(std::ostream& output)
+        : output_{output}
+    {
+        buffer_.reserve(generatorChunkSize);
+    }
+
+    DataWriter(const DataWriter&) = delete;
+    DataWriter& operator=(const DataWriter&) = delete;
+
+    void write(std::string_view data)
+    {
+        buffer_ += data;
+        if (std::ssize(buffer_) >= generatorChunkSize)
+            flush();
+    }
+
+    void flush()
+    {
+        output_.write(buffer_.data(), std::ssize(buffer_));
+        buffer_.clear();
+    }
+
+private:
+    std::ostream& output_;
+    std::string buffer_;
+};
+
+void generateRandomBytes(std::int64_t size, std::uint64_t seed, DataWriter& writer)
+{
+    // The output of std::mt19937_64 is specified by the standard, unlike the output of the distributions,
+    // so the bytes are taken directly from the engine values
+    auto engine = std::mt19937_64{seed};
+    auto bytes = std::array<char, 8>{};
+    for (auto pos = std::int64_t{0}; pos < size; pos += std::ssize(bytes)) {
+        auto value = engine();
+        for (auto& byte : bytes) {
+            byte = static_cast<char>(value & 0xFF);
+            value >>= 8;
+        }
+        writer.write({bytes.data(), static_cast<std::size_t>(std::min<std::int64_t>(std::ssize(bytes), size - pos))});
+    }
+}
+
+void generateRepeatedLines(std::int64_t count, const std::string& line, DataWriter& writer)
+{
+    for (auto i = std::int64_t{0}; i < count; ++i) {
+        writer.write(line);
+        writer.write("\n");
+    }
+}
+
+void generateCsvRows(
+        std::int64_t count,
+        std::uint64_t seed,
+        const std::vector<std::string>& columns,
+        DataWriter& writer)
+{
+    auto engine = std::mt19937_64{seed};
+    writer.write(sfun::join(columns, ","));
+    writer.write("\n");
+    for (auto i = std::int64_t{0}; i < count; ++i) {
+        for (auto column = std::size_t{0}; column < columns.size(); ++column) {
+            if (column)
+                writer.write(",");
+            writer.write(std::to_string(engine() % csvValueRange));
+        }
+        writer.write("\n");
+    }
+}
+
+bool cloneFile(const fs::path& srcPath, const fs::path& dstPath)
+{
+#ifdef __linux__
+    const auto srcFile = open(srcPath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (srcFile < 0)
+        return false;
+    const auto dstFile = open(dstPath.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+    if (dstFile < 0) {
+        close(srcFile);
+        return false;
+    }
+    const auto isCloned = ioctl(dstFile, FICLONE, srcFile) == 0;
+    close(srcFile);
+    close(dstFile);
+    if (!isCloned)
+        fs::remove(dstPath);
+    return isCloned;
+#else
+    static_cast<void>(srcPath);
+    static_cast<void>(dstPath);
+    return false;
+#endif
+}
+
+void makeCachedFileCopy(const fs::path& cachedFilePath, const fs::path& filePath)
+{
+    // The cached file is shared between tests, so it's cloned with copy-on-write when the file system supports it.
+    // Otherwise, it's copied, as a test modifying a hard link would corrupt the cached file.
+    if (cloneFile(cachedFilePath, filePath))
+        return;
+
+    fs::copy_file(cachedFilePath, filePath);
+    fs::permissions(filePath, fs::perms::owner_write, fs::perm_options::add);
+}
+
+void writeCachedFile(const GeneratedDataSpec& spec, const fs::path& cachedFilePath)
+{
+    // The data is written to a temporary file and renamed, so the tests launched in parallel
+    // or by another lunchtoast process never see a partially written cached file
+    fs::create_directories(cachedFilePath.parent_path());
+    auto random = std::random_device{};
+    const auto tempFilePath = fs::path{cachedFilePath}.concat(fmt::format(".{:x}.tmp", random()));
+    try {
+        auto fileStream = std::ofstream{tempFilePath, std::ios::binary};
+        fileStream.exceptions(std::ofstream::failbit | std::ofstream::badbit);
+        generateData(spec, fileStream);
+    }
+    catch (...) {
+        auto error = std::error_code{};
+        fs::remove(tempFilePath, error);
+        throw;
+    }
+    fs::permissions(
+            tempFilePath,
+            fs::perms::owner_read | fs::perms::group_read | fs::perms::others_read,
+            fs::perm_options::replace);
+    fs::rename(tempFilePath, cachedFilePath);
+}
+
+} //namespace
+
+GeneratedDataSpec readGeneratedDataSpec(const std::string& specStr)
+{
+    auto spec = GeneratedDataSpec{};
+    auto dataTypesCount = 0;
+    auto hasLine = false;
+    auto stream = std::istringstream{specStr};
+    auto specLine = std::string{};
+    while (std::getline(stream, specLine)) {
+        const auto paramLine = sfun::trim(specLine);
+        if (paramLine.empty())
+            continue;
+        const auto paramName = sfun::before(paramLine, "=");
+        if (!paramName.has_value())
+            throw TestConfigError{fmt::format(
+                    "Invalid generated data parameter '{}', it must be specified like 'random bytes = 100 MB'",
+                    paramLine)};
+        const auto name = sfun::trim(paramName.value());
+        const auto value = sfun::trim(sfun::after(paramLine, "=").value());
+
+        if (name == "seed")
+            spec.seed = readSpecNumber<std::uint64_t>(name, value);
+        else if (name == "line") {
+            spec.line = std::string{value};
+            hasLine = true;
+        }
+        else if (name == "columns") {
+            spec.columns.clear();
+            for (const auto column : sfun::split(value, ","))
+                spec.columns.emplace_back(sfun::trim(column));
+        }
+        else if (name == dataTypeName(GeneratedDataType::RandomBytes)) {
+            const auto size = readDataSize(value);
+            if (!size.has_value())
+                throw TestConfigError{
+                        fmt::format("Invalid random bytes size '{}', it must be specified like '100 MB'", value)};
+            spec.type = GeneratedDataType::RandomBytes;
+            spec.size = size.value();
+            ++dataTypesCount;
+        }
+        else if (name == dataTypeName(GeneratedDataType::RepeatedLines)) {
+            spec.type = GeneratedDataType::RepeatedLines;
+            spec.size = readSpecCount(name, value);
+            ++dataTypesCount;
+        }
+        else if (name == dataTypeName(GeneratedDataType::CsvRows)) {
+            spec.type = GeneratedDataType::CsvRows;
+            spec.size = readSpecCount(name, value);
+            ++dataTypesCount;
+        }
+        else
+            throw TestConfigError{fmt::format("Unknown generated data parameter '{}'", name)};
+    }
+
+    if (dataTypesCount != 1)
+        throw TestConfigError{
+                "Generated data must be specified with one of the parameters: "
+                "'random bytes', 'repeated lines' or 'CSV rows'"};
+    if (spec.type == GeneratedDataType::RepeatedLines && !hasLine)
+        throw TestConfigError{"Generated repeated lines must be specified with the 'line' parameter"};
+    if (spec.type == GeneratedDataType::CsvRows && spec.columns.empty())
+        throw TestConfigError{"Generated CSV rows must be specified with the 'columns' parameter"};
+    return spec;
+}
+
+std::string generatedDataKey(const GeneratedDataSpec& spec)
+{
+    const auto keyStr = fmt::format(
+            "{}\n{}\n{}\n{}\n{}\n{}",
+            generatedDataVersion,
+            dataTypeName(spec.type),
+            spec.size,
+            spec.seed,
+            spec.line,
+            sfun::join(spec.columns, "\n"));
+    return fmt::format("{:016x}", fnv1aHash(keyStr));
+}
+
+void generateData(const GeneratedDataSpec& spec, std::ostream& output)
+{
+    auto writer = DataWriter{output};
+    switch (spec.type) {
+    case GeneratedDataType::RandomBytes:
+        generateRandomBytes(spec.size, spec.seed, writer);
+        break;
+    case GeneratedDataType::RepeatedLines:
+        generateRepeatedLines(spec.size, spec.line, writer);
+        break;
+    case GeneratedDataType::CsvRows:
+        generateCsvRows(spec.size, spec.seed, spec.columns, writer);
+        break;
+    }
+    writer.flush();
+}
+
+GenerateFile::GenerateFile(fs::path filePath, GeneratedDataSpec spec, fs::path cacheDir)
+    : filePath_(std::move(filePath))
+    , spec_(std::move(spec))
+    , cacheDir_(std::move(cacheDir))
+{
+}
+
+TestActionResult GenerateFile::operator()() const
+{
+    const auto cachedFilePath = cacheDir_ / (generatedDataKey(spec_) + ".data");
+    try {
+        if (!fs::exists(cachedFilePath))
+            writeCachedFile(spec_, cachedFilePath);
+        fs::remove(filePath_);
+        makeCachedFileCopy(cachedFilePath, filePath_);
+    }
+    catch (const std::exception& e) {
+        return TestActionResult::Failure(
+                fmt::format("File {} generating error: {}", sfun::path_string(filePath_), e.what()));
+    }
+    return TestActionResult::Success();
+}
+
+} //namespace lunchtoast
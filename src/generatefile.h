@@ -0,0 +1,43 @@
+#pragma once
+#include "testactionresult.h"
+#include <cstdint>
+#include <filesystem>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace lunchtoast {
+
+enum class GeneratedDataType {
+    RandomBytes,
+    RepeatedLines,
+    CsvRows
+};
+
+// Specification of the data produced by the "Generate <filename>" section, read from lines like
+// "random bytes = 100 MB", "repeated lines = 1000", "CSV rows = 1000" and "seed = 42"
+struct GeneratedDataSpec {
+    GeneratedDataType type = GeneratedDataType::RandomBytes;
+    std::int64_t size = 0;
+    std::uint64_t seed = 0;
+    std::string line;
+    std::vector<std::string> columns;
+};
+
+GeneratedDataSpec readGeneratedDataSpec(const std::string& specStr);
+// The same specification always produces the same data, so its hash is used as the data key in the cache
+std::string generatedDataKey(const GeneratedDataSpec& spec);
+void generateData(const GeneratedDataSpec& spec, std::ostream& output);
+
+class GenerateFile {
+public:
+    GenerateFile(std::filesystem::path filePath, GeneratedDataSpec spec, std::filesystem::path cacheDir);
+    TestActionResult operator()() const;
+
+private:
+    std::filesystem::path filePath_;
+    GeneratedDataSpec spec_;
+    std::filesystem::path cacheDir_;
+};
+
+} //namespace lunchtoast
@@ -1,6 +1,8 @@
 #include "launchprocess.h"
 #include "constants.h"
 #include "errors.h"
+#include "outputchecker.h"
+#include "performancebaseline.h"
 #include "testaction.h"
 #include "utils.h"
 #include <fmt/format.h>
@@ -13,10 +15,22 @@
 #include <sfun/wstringconv.h>
 #include <boost/asio.hpp>
 #include <boost/process.hpp>
+#include <boost/process/extend.hpp>
+#include <gsl/util>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
 #include <filesystem>
+#include <system_error>
 #include <fstream>
-#include <future>
+#include <mutex>
 #include <utility>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
 
 namespace lunchtoast {
 namespace views = ranges::views;
@@ -30,7 +44,10 @@ LaunchProcess::LaunchProcess(
         std::set<ProcessResultCheckMode> checkModeSet,
         int actionIndex,
         sfun::optional_ref<std::vector<boost::process::child>> detachedProcessList,
-        bool skipReadingOutput)
+        bool skipReadingOutput,
+        ProcessLimits limits,
+        ProcessInput input,
+        sfun::optional_ref<TestCancellation> cancellation)
     : command_{std::move(command)}
     , workingDir_{std::move(workingDir)}
     , shellCommand_{std::move(shellCommand)}
@@ -38,6 +55,9 @@ LaunchProcess::LaunchProcess(
     , actionIndex_{actionIndex}
     , detachedProcessList_{detachedProcessList}
     , skipReadingOutput_{skipReadingOutput}
+    , limits_{limits}
+    , input_{std::move(input)}
+    , cancellation_{cancellation}
 {
     auto paths = boost::this_process::path();
 }
@@ -94,7 +114,60 @@ std::string failureReportFilename(int actionIndex)
     return fmt::format(hardcoded::launchFailureReportFilename, actionIndex);
 }
 
-auto makeCheckModeVisitor(const LaunchProcessResult& result, const std::string& command, int actionIndex)
+std::string dataSizeString(std::int64_t size)
+{
+    return fmt::format("{} KB", size / 1024);
+}
+
+std::string performanceMetricName(PerformanceMetric metric)
+{
+    return metric == PerformanceMetric::Duration ? "duration" : "max memory";
+}
+
+std::string performanceValueString(PerformanceMetric metric, std::int64_t value)
+{
+    // Durations are measured in microseconds
+    return metric == PerformanceMetric::Duration ? fmt::format("{:.3f} ms", static_cast<double>(value) / 1000)
+                                                 : dataSizeString(value);
+}
+
+template<typename TCheckMode>
+const TCheckMode* findCheckMode(const std::set<ProcessResultCheckMode>& checkModeSet)
+{
+    for (const auto& checkMode : checkModeSet)
+        if (const auto result = std::get_if<TCheckMode>(&checkMode.value))
+            return result;
+    return nullptr;
+}
+
+struct PerformanceMeasurement {
+    PerformanceStats stats;
+    std::optional<PerformanceStats> baselineStats;
+};
+
+struct OutputCheckers {
+    OutputChecker output;
+    OutputChecker errorOutput;
+};
+
+OutputCheckers makeOutputCheckers(const std::set<ProcessResultCheckMode>& checkModeSet)
+{
+    auto result = OutputCheckers{};
+    for (const auto& checkMode : checkModeSet) {
+        if (const auto output = std::get_if<ProcessResultCheckMode::Output>(&checkMode.value))
+            result.output = OutputChecker{output->type, output->value, output->ignoredLinesPattern};
+        else if (const auto errorOutput = std::get_if<ProcessResultCheckMode::ErrorOutput>(&checkMode.value))
+            result.errorOutput = OutputChecker{errorOutput->type, errorOutput->value, errorOutput->ignoredLinesPattern};
+    }
+    return result;
+}
+
+auto makeCheckModeVisitor(
+        const LaunchProcessResult& result,
+        const OutputCheckers& outputCheckers,
+        const std::optional<PerformanceMeasurement>& performance,
+        const std::string& command,
+        int actionIndex)
 {
     return sfun::overloaded{
             [&, actionIndex = actionIndex](const ProcessResultCheckMode::ExitCode& exitCode)
@@ -102,6 +175,12 @@ auto makeCheckModeVisitor(const LaunchProcessResult& result, const std::string&
                 if (!exitCode.value.has_value())
                     return TestActionResult::Success();
 
+                if (result.terminationSignal.has_value())
+                    return TestActionResult::Failure(fmt::format(
+                            "Launched process '{}' was killed by signal {}. More info in {}",
+                            command,
+                            result.terminationSignal.value(),
+                            failureReportFilename(actionIndex)));
                 if (result.exitCode != exitCode.value)
                     return TestActionResult::Failure(fmt::format(
                             "Launched process '{}' returned unexpected exit code {}. More info in {}",
@@ -110,140 +189,716 @@ auto makeCheckModeVisitor(const LaunchProcessResult& result, const std::string&
                             failureReportFilename(actionIndex)));
                 return TestActionResult::Success();
             },
-            [&, actionIndex = actionIndex](const ProcessResultCheckMode::Output& output)
+            [&, actionIndex = actionIndex](const ProcessResultCheckMode::Output&)
             {
-                if (result.output != normalizeLineEndings(output.value))
+                if (!outputCheckers.output.isSuccessful())
                     return TestActionResult::Failure(fmt::format(
                             "Launched process '{}' returned unexpected output. More info in {}",
                             command,
                             failureReportFilename(actionIndex)));
                 return TestActionResult::Success();
             },
-            [&, actionIndex = actionIndex](const ProcessResultCheckMode::ErrorOutput& output)
+            [&, actionIndex = actionIndex](const ProcessResultCheckMode::ErrorOutput&)
             {
-                if (result.errorOutput != normalizeLineEndings(output.value))
+                if (!outputCheckers.errorOutput.isSuccessful())
                     return TestActionResult::Failure(fmt::format(
                             "Launched process '{}' returned unexpected error output. More info in {}",
                             command,
                             failureReportFilename(actionIndex)));
                 return TestActionResult::Success();
+            },
+            [&, actionIndex = actionIndex](const ProcessResultCheckMode::MaxMemory& maxMemory)
+            {
+                if (result.resourceUsage.maxResidentSetSize > maxMemory.value)
+                    return TestActionResult::Failure(fmt::format(
+                            "Launched process '{}' used {} of memory, exceeding the limit of {}. More info in {}",
+                            command,
+                            dataSizeString(result.resourceUsage.maxResidentSetSize),
+                            dataSizeString(maxMemory.value),
+                            failureReportFilename(actionIndex)));
+                return TestActionResult::Success();
+            },
+            [&, actionIndex = actionIndex](const ProcessResultCheckMode::MaxDuration& maxDuration)
+            {
+                if (result.resourceUsage.wallTime > maxDuration.value)
+                    return TestActionResult::Failure(fmt::format(
+                            "Launched process '{}' took {} ms, exceeding the limit of {} ms. More info in {}",
+                            command,
+                            result.resourceUsage.wallTime.count(),
+                            maxDuration.value.count(),
+                            failureReportFilename(actionIndex)));
+                return TestActionResult::Success();
+            },
+            [&, actionIndex = actionIndex](const ProcessResultCheckMode::PerformanceBaseline& baseline)
+            {
+                if (baseline.updateBaseline)
+                    return TestActionResult::Success();
+                if (!performance->baselineStats.has_value())
+                    return TestActionResult::Failure(fmt::format(
+                            "Performance baseline file {} doesn't exist, use --updateBaselines flag to create it",
+                            sfun::path_string(baseline.baselineFile.filename())));
+
+                const auto& baselineStats = performance->baselineStats.value();
+                if (exceedsPerformanceBaseline(performance->stats, baselineStats, baseline.tolerancePercent))
+                    return TestActionResult::Failure(fmt::format(
+                            "Launched process '{}' median {} {} exceeds the baseline {} by more than {}%. "
+                            "More info in {}",
+                            command,
+                            performanceMetricName(baseline.metric),
+                            performanceValueString(baseline.metric, performance->stats.median),
+                            performanceValueString(baseline.metric, baselineStats.median),
+                            baseline.tolerancePercent,
+                            failureReportFilename(actionIndex)));
+                return TestActionResult::Success();
             }};
 }
 
+// Reads the pipe in chunks and passes them to the output checker,
+// so the output checks don't require to store the whole process output
+template<typename TPipe>
+class PipeReader {
+public:
+    PipeReader(TPipe& pipe, OutputChecker& outputChecker)
+        : pipe_{pipe}
+        , outputChecker_{outputChecker}
+        , buffer_(64 * 1024)
+    {
+    }
+
+    void read()
+    {
+        pipe_.get().async_read_some(
+                boost::asio::buffer(buffer_),
+                [this](const boost::system::error_code& error, std::size_t size)
+                {
+                    outputChecker_.get().write(std::string_view{buffer_.data(), size});
+                    if (!error)
+                        read();
+                });
+    }
+
+private:
+    sfun::member<TPipe&> pipe_;
+    sfun::member<OutputChecker&> outputChecker_;
+    std::vector<char> buffer_;
+};
+
+// Writes the input text to the pipe while the process output is read on the same io_service,
+// so the process can't get stuck writing its output while lunchtoast is writing its input
+template<typename TPipe>
+class PipeWriter {
+public:
+    PipeWriter(TPipe& pipe, const std::string& text)
+        : pipe_{pipe}
+        , text_{text}
+    {
+    }
+
+    void write()
+    {
+        boost::asio::async_write(
+                pipe_.get(),
+                boost::asio::buffer(text_.data(), text_.size()),
+                [this](const boost::system::error_code&, std::size_t)
+                {
+                    // The process can exit without reading the whole input, so the write errors are ignored
+                    pipe_.get().close();
+                });
+    }
+
+private:
+    sfun::member<TPipe&> pipe_;
+    std::string_view text_;
+};
+
+// Processes are launched under this lock, and the pipes are created under it with the close-on-exec flag,
+// so the processes of the tests running in parallel don't inherit the pipe ends of each other.
+// Otherwise the output of a test isn't closed until all the processes holding its pipe ends exit.
+std::mutex& processLaunchMutex()
+{
+    static auto mutex = std::mutex{};
+    return mutex;
+}
+
+proc::async_pipe makeAsyncPipe(boost::asio::io_service& ios)
+{
+    auto pipe = proc::async_pipe{ios};
+#ifndef _WIN32
+    for (const auto fd : {pipe.native_source(), pipe.native_sink()})
+        if (::fcntl(fd, F_SETFD, FD_CLOEXEC) == -1)
+            throw std::system_error{errno, std::system_category(), "Couldn't create a pipe"};
+#endif
+    return pipe;
+}
+
+// Input files are passed as the process stdin directly, the input text is written through the pipe,
+// and without the input the process inherits the stdin of lunchtoast
+template<typename... TArgs>
+proc::child makeChildProcess(const ProcessInput& input, proc::async_pipe& stdinPipe, TArgs&&... args)
+{
+    if (input.file.has_value())
+        return proc::child{args..., proc::std_in < boost::filesystem::path{input.file->native()}};
+    if (input.text.has_value())
+        return proc::child{args..., proc::std_in < stdinPipe};
+    return proc::child{args...};
+}
+
+#ifndef _WIN32
+std::chrono::milliseconds toMilliseconds(const timeval& time)
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::seconds{time.tv_sec} + std::chrono::microseconds{time.tv_usec});
+}
+#endif
+
+// The process is reaped with wait4 instead of boost::process::child::wait, as it's the only way
+// to get the resource usage of a single child process
+std::tuple<int, std::optional<int>, ProcessResourceUsage> waitForProcess(
+        proc::child& process,
+        std::chrono::steady_clock::time_point startTime,
+        sfun::optional_ref<TestCancellation> cancellation)
+{
+    auto resourceUsage = ProcessResourceUsage{};
+    const auto wallTime = [&]
+    {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime);
+    };
+#ifndef _WIN32
+    // The process group is unregistered after the exit of its leader, but before reaping it,
+    // so the process id can't be reused by another process while the group is registered
+    if (cancellation.has_value()) {
+        auto info = siginfo_t{};
+        auto waitResult = 0;
+        do {
+            waitResult = ::waitid(P_PID, static_cast<id_t>(process.id()), &info, WEXITED | WNOWAIT);
+        } while (waitResult == -1 && errno == EINTR);
+        cancellation->unregisterProcessGroup(process.id());
+    }
+
+    auto status = 0;
+    auto usage = rusage{};
+    auto waitResult = pid_t{};
+    do {
+        waitResult = wait4(process.id(), &status, 0, &usage);
+    } while (waitResult == -1 && errno == EINTR);
+    if (waitResult == -1) {
+        process.wait();
+        resourceUsage.wallTime = wallTime();
+        return {process.exit_code(), std::nullopt, resourceUsage};
+    }
+    process.detach();
+
+    resourceUsage.wallTime = wallTime();
+    resourceUsage.userCpuTime = toMilliseconds(usage.ru_utime);
+    resourceUsage.systemCpuTime = toMilliseconds(usage.ru_stime);
+#ifdef __APPLE__
+    resourceUsage.maxResidentSetSize = usage.ru_maxrss;
+#else
+    resourceUsage.maxResidentSetSize = std::int64_t{usage.ru_maxrss} * 1024;
+#endif
+    resourceUsage.inputBlocks = usage.ru_inblock;
+    resourceUsage.outputBlocks = usage.ru_oublock;
+    const auto exitCode = WIFEXITED(status) ? WEXITSTATUS(status) : (WIFSIGNALED(status) ? WTERMSIG(status) : status);
+    const auto terminationSignal = WIFSIGNALED(status) ? std::optional{WTERMSIG(status)} : std::nullopt;
+    return {exitCode, terminationSignal, resourceUsage};
+#else
+    process.wait();
+    resourceUsage.wallTime = wallTime();
+    return {process.exit_code(), std::nullopt, resourceUsage};
+#endif
+}
+
+// Limits are set in the child process before executing the command, so the launched process isn't wrapped
+class ProcessLimitsSetup : public proc::extend::handler {
+public:
+    explicit ProcessLimitsSetup(const ProcessLimits& limits)
+        : limits_{limits}
+    {
+    }
+
+#ifndef _WIN32
+    template<typename TExecutor>
+    void on_exec_setup(TExecutor& executor) const
+    {
+        if (!applyProcessLimits(limits_))
+            executor.set_error(std::error_code{errno, std::system_category()}, "Couldn't set the process limits");
+    }
+#endif
+
+private:
+    const ProcessLimits& limits_;
+};
+
+// Processes of the tests that can be cancelled are launched in their own process groups,
+// so the processes started by the launched commands are killed together with them
+class ProcessGroupSetup : public proc::extend::handler {
+public:
+    explicit ProcessGroupSetup(sfun::optional_ref<TestCancellation> cancellation)
+        : cancellation_{cancellation}
+    {
+    }
+
+#ifndef _WIN32
+    template<typename TExecutor>
+    void on_exec_setup(TExecutor&) const
+    {
+        if (cancellation_.has_value())
+            ::setpgid(0, 0);
+    }
+
+    // The process group is also set in the parent process, so it exists before the process can be killed
+    template<typename TExecutor>
+    void on_success(TExecutor& executor) const
+    {
+        if (!cancellation_.has_value())
+            return;
+        ::setpgid(executor.pid, executor.pid);
+        cancellation_->registerProcessGroup(executor.pid);
+    }
+#endif
+
+private:
+    sfun::optional_ref<TestCancellation> cancellation_;
+};
+
+// SIGPIPE is ignored by lunchtoast and ignored signals are inherited through exec,
+// so the launched processes get the default SIGPIPE handling back
+class DefaultSignalsSetup : public proc::extend::handler {
+public:
+#ifndef _WIN32
+    template<typename TExecutor>
+    void on_exec_setup(TExecutor&) const
+    {
+        std::signal(SIGPIPE, SIG_DFL);
+    }
+#endif
+};
+
 LaunchProcessResult startProcess(
         const boost::filesystem::path& cmd,
         const std::vector<std::string>& cmdArgs,
-        const std::filesystem::path& workingDir)
+        const std::filesystem::path& workingDir,
+        const ProcessLimits& limits,
+        const ProcessInput& input,
+        OutputCheckers& outputCheckers,
+        sfun::optional_ref<TestCancellation> cancellation)
 {
+    const auto startTime = std::chrono::steady_clock::now();
     auto ios = boost::asio::io_service{};
-    auto stdoutData = std::future<std::string>{};
-    auto stderrData = std::future<std::string>{};
-    auto process = proc::child{
+    auto launchLock = std::unique_lock{processLaunchMutex()};
+    auto stdinPipe = makeAsyncPipe(ios);
+    auto stdoutPipe = makeAsyncPipe(ios);
+    auto stderrPipe = makeAsyncPipe(ios);
+    auto process = makeChildProcess(
+            input,
+            stdinPipe,
             cmd,
             proc::args(osArgs(cmdArgs)),
             proc::start_dir = sfun::path_string(workingDir),
-            proc::std_out > stdoutData,
-            proc::std_err > stderrData,
-            ios};
+            proc::std_out > stdoutPipe,
+            proc::std_err > stderrPipe,
+            ProcessLimitsSetup{limits},
+            ProcessGroupSetup{cancellation},
+            DefaultSignalsSetup{},
+            ios);
+    launchLock.unlock();
 
+    auto stdinWriter = std::optional<PipeWriter<proc::async_pipe>>{};
+    auto stdoutReader = PipeReader{stdoutPipe, outputCheckers.output};
+    auto stderrReader = PipeReader{stderrPipe, outputCheckers.errorOutput};
+    if (input.text.has_value()) {
+        stdinWriter.emplace(stdinPipe, input.text.value());
+        stdinWriter->write();
+    }
+    stdoutReader.read();
+    stderrReader.read();
     ios.run();
-    process.wait();
-    if (process.running())
-        process.terminate();
+    const auto [exitCode, terminationSignal, resourceUsage] = waitForProcess(process, startTime, cancellation);
 
-    return {.exitCode = process.exit_code(),
-            .output = normalizeLineEndings(stdoutData.get()),
-            .errorOutput = normalizeLineEndings(stderrData.get())};
+    outputCheckers.output.close();
+    outputCheckers.errorOutput.close();
+    return {.exitCode = exitCode,
+            .output = std::string{outputCheckers.output.output()},
+            .errorOutput = std::string{outputCheckers.errorOutput.output()},
+            .resourceUsage = resourceUsage,
+            .terminationSignal = terminationSignal};
 }
 
 LaunchProcessResult startProcessWithoutReadingOutput(
         const boost::filesystem::path& cmd,
         const std::vector<std::string>& cmdArgs,
-        const std::filesystem::path& workingDir)
+        const std::filesystem::path& workingDir,
+        const ProcessLimits& limits,
+        const ProcessInput& input,
+        sfun::optional_ref<TestCancellation> cancellation)
 {
+    const auto startTime = std::chrono::steady_clock::now();
     auto ios = boost::asio::io_service{};
-    auto process = proc::child{
+    auto launchLock = std::unique_lock{processLaunchMutex()};
+    auto stdinPipe = makeAsyncPipe(ios);
+    auto process = makeChildProcess(
+            input,
+            stdinPipe,
             cmd,
             proc::args(osArgs(cmdArgs)),
             proc::start_dir = sfun::path_string(workingDir),
             proc::std_out > proc::null,
             proc::std_err > proc::null,
-            ios};
+            ProcessLimitsSetup{limits},
+            ProcessGroupSetup{cancellation},
+            DefaultSignalsSetup{},
+            ios);
+    launchLock.unlock();
 
+    auto stdinWriter = std::optional<PipeWriter<proc::async_pipe>>{};
+    if (input.text.has_value()) {
+        stdinWriter.emplace(stdinPipe, input.text.value());
+        stdinWriter->write();
+    }
     ios.run();
-    process.wait();
-    if (process.running())
-        process.terminate();
+    const auto [exitCode, terminationSignal, resourceUsage] = waitForProcess(process, startTime, cancellation);
+    return {.exitCode = exitCode,
+            .output = {},
+            .errorOutput = {},
+            .resourceUsage = resourceUsage,
+            .terminationSignal = terminationSignal};
+}
+
+// The first launch of the process is treated as a warm-up run, so its result isn't used in the measurement
+std::optional<PerformanceMeasurement> measurePerformance(
+        const boost::filesystem::path& cmd,
+        const std::vector<std::string>& cmdArgs,
+        const std::filesystem::path& workingDir,
+        const ProcessLimits& limits,
+        const ProcessInput& input,
+        const std::set<ProcessResultCheckMode>& checkModeSet,
+        sfun::optional_ref<TestCancellation> cancellation)
+{
+    const auto baseline = findCheckMode<ProcessResultCheckMode::PerformanceBaseline>(checkModeSet);
+    if (!baseline)
+        return std::nullopt;
+
+    auto values = std::vector<std::int64_t>{};
+    for (auto i = 0; i < baseline->repetitions; ++i) {
+        const auto startTime = std::chrono::steady_clock::now();
+        const auto result = startProcessWithoutReadingOutput(cmd, cmdArgs, workingDir, limits, input, cancellation);
+        // Durations are measured in microseconds, so the baselines of short processes aren't rounded to zero
+        const auto duration =
+                std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime);
+        values.push_back(
+                baseline->metric == PerformanceMetric::Duration ? duration.count()
+                                                                : result.resourceUsage.maxResidentSetSize);
+    }
 
-    return {.exitCode = process.exit_code(), .output = {}, .errorOutput = {}};
+    const auto stats = calculatePerformanceStats(std::move(values));
+    if (baseline->updateBaseline)
+        writePerformanceBaseline(stats, baseline->baselineFile);
+    return PerformanceMeasurement{.stats = stats, .baselineStats = readPerformanceBaseline(baseline->baselineFile)};
 }
 
 proc::child startDetachedProcess(
         const boost::filesystem::path& cmd,
         const std::vector<std::string>& cmdArgs,
-        const std::filesystem::path& workingDir)
+        const std::filesystem::path& workingDir,
+        const ProcessLimits& limits,
+        const std::optional<std::filesystem::path>& inputFile)
 {
+    const auto launchLock = std::scoped_lock{processLaunchMutex()};
+    if (inputFile.has_value())
+        return proc::child{
+                cmd,
+                proc::args(osArgs(cmdArgs)),
+                proc::start_dir = sfun::path_string(workingDir),
+                proc::std_in < boost::filesystem::path{inputFile->native()},
+                proc::std_out > proc::null,
+                proc::std_err > proc::null,
+                ProcessLimitsSetup{limits},
+                DefaultSignalsSetup{}};
+
     return proc::child{
             cmd,
             proc::args(osArgs(cmdArgs)),
             proc::start_dir = sfun::path_string(workingDir),
             proc::std_out > proc::null,
-            proc::std_err > proc::null};
+            proc::std_err > proc::null,
+            ProcessLimitsSetup{limits},
+            DefaultSignalsSetup{}};
 }
 
-struct ExpectedLaunchProcessResult {
-    std::optional<int> exitCode;
-    std::optional<std::string> output;
-    std::optional<std::string> errorOutput;
+#ifndef _WIN32
+struct PipelineStage {
+    boost::filesystem::path cmd;
+    std::vector<std::string> args;
 };
 
-auto makeCheckModeVisitorSettingExpectedResult(ExpectedLaunchProcessResult& expectedResult)
+struct PipelineResult {
+    std::vector<LaunchProcessResult> stages;
+    std::chrono::milliseconds duration;
+};
+
+// Pipes of the pipeline are created with the close-on-exec flag, so each stage keeps only the pipe ends
+// duplicated to its standard streams, and the stage reading the pipe gets EOF when the previous stage exits
+std::tuple<boost::asio::posix::stream_descriptor, boost::asio::posix::stream_descriptor> makePipe(
+        boost::asio::io_service& ios)
 {
-    return sfun::overloaded{
-            [&](const ProcessResultCheckMode::ExitCode& exitCode)
-            {
-                expectedResult.exitCode = exitCode.value;
-            },
-            [&](const ProcessResultCheckMode::Output& output)
-            {
-                expectedResult.output = normalizeLineEndings(output.value);
-            },
-            [&](const ProcessResultCheckMode::ErrorOutput& output)
+    int fds[2];
+#ifdef __APPLE__
+    const auto isCreated = ::pipe(fds) == 0;
+#else
+    const auto isCreated = ::pipe2(fds, O_CLOEXEC) == 0;
+#endif
+    if (!isCreated)
+        throw std::system_error{errno, std::system_category(), "Couldn't create a pipe"};
+
+    auto result = std::tuple{
+            boost::asio::posix::stream_descriptor{ios, fds[0]},
+            boost::asio::posix::stream_descriptor{ios, fds[1]}};
+#ifdef __APPLE__
+    for (const auto fd : fds)
+        if (::fcntl(fd, F_SETFD, FD_CLOEXEC) == -1)
+            throw std::system_error{errno, std::system_category(), "Couldn't create a pipe"};
+#endif
+    return result;
+}
+
+// Standard streams of the pipeline stage are redirected in the child process before executing its command,
+// the descriptor -1 leaves the stream inherited from lunchtoast
+class PipelineStageStreamsSetup : public proc::extend::handler {
+public:
+    PipelineStageStreamsSetup(int inputFd, int outputFd, int errorOutputFd)
+        : inputFd_{inputFd}
+        , outputFd_{outputFd}
+        , errorOutputFd_{errorOutputFd}
+    {
+    }
+
+    template<typename TExecutor>
+    void on_exec_setup(TExecutor& executor) const
+    {
+        const auto redirect = [](int fd, int streamFd)
+        {
+            return fd == -1 || ::dup2(fd, streamFd) != -1;
+        };
+        if (!redirect(inputFd_, STDIN_FILENO) || !redirect(outputFd_, STDOUT_FILENO) ||
+            !redirect(errorOutputFd_, STDERR_FILENO))
+            executor.set_error(
+                    std::error_code{errno, std::system_category()},
+                    "Couldn't redirect the standard streams of the pipeline stage");
+    }
+
+private:
+    int inputFd_;
+    int outputFd_;
+    int errorOutputFd_;
+};
+
+// The output of the last stage and the error output of all stages are read on the same io_service
+// that writes the input text, the processes are reaped after all of them close their output
+PipelineResult startPipeline(
+        const std::vector<PipelineStage>& stages,
+        const std::filesystem::path& workingDir,
+        const ProcessLimits& limits,
+        const ProcessInput& input,
+        OutputCheckers& outputCheckers,
+        sfun::optional_ref<TestCancellation> cancellation)
+{
+    const auto startTime = std::chrono::steady_clock::now();
+    auto ios = boost::asio::io_service{};
+    auto launchLock = std::unique_lock{processLaunchMutex()};
+    auto [stdoutReadEnd, stdoutWriteEnd] = makePipe(ios);
+    auto [stderrReadEnd, stderrWriteEnd] = makePipe(ios);
+
+    auto inputFileFd = -1;
+    const auto closeInputFile = gsl::finally(
+            [&]
             {
-                expectedResult.errorOutput = normalizeLineEndings(output.value);
-            }};
+                if (inputFileFd != -1)
+                    ::close(inputFileFd);
+            });
+    if (input.file.has_value()) {
+        inputFileFd = ::open(input.file->c_str(), O_RDONLY | O_CLOEXEC);
+        if (inputFileFd == -1)
+            throw std::system_error{
+                    errno,
+                    std::system_category(),
+                    fmt::format("Couldn't open the input file '{}'", homePathString(input.file.value()))};
+    }
+
+    auto stdinWriteEnd = std::optional<boost::asio::posix::stream_descriptor>{};
+    auto stageInput = std::optional<boost::asio::posix::stream_descriptor>{};
+    if (input.text.has_value()) {
+        auto [readEnd, writeEnd] = makePipe(ios);
+        stageInput.emplace(std::move(readEnd));
+        stdinWriteEnd.emplace(std::move(writeEnd));
+    }
+
+    // Processes that are already started are terminated by the destructor of boost::process::child
+    // if the launch of the following stage fails
+    auto processes = std::vector<proc::child>{};
+    for (const auto& stage : stages) {
+        const auto isLastStage = &stage == &stages.back();
+        auto stageOutput = std::optional<boost::asio::posix::stream_descriptor>{};
+        auto nextStageInput = std::optional<boost::asio::posix::stream_descriptor>{};
+        if (!isLastStage) {
+            auto [readEnd, writeEnd] = makePipe(ios);
+            nextStageInput.emplace(std::move(readEnd));
+            stageOutput.emplace(std::move(writeEnd));
+        }
+
+        // Only the first stage can be launched without the input pipe
+        const auto inputFd = stageInput.has_value() ? stageInput->native_handle() : inputFileFd;
+        const auto outputFd = stageOutput.has_value() ? stageOutput->native_handle() : stdoutWriteEnd.native_handle();
+        processes.emplace_back(
+                stage.cmd,
+                proc::args(osArgs(stage.args)),
+                proc::start_dir = sfun::path_string(workingDir),
+                PipelineStageStreamsSetup{inputFd, outputFd, stderrWriteEnd.native_handle()},
+                ProcessLimitsSetup{limits},
+                ProcessGroupSetup{cancellation},
+                DefaultSignalsSetup{});
+
+        // Pipe ends passed to the launched stage are closed in lunchtoast, so they're owned only by the stages
+        stageInput.reset();
+        stageInput = std::move(nextStageInput);
+    }
+    launchLock.unlock();
+    stdoutWriteEnd.close();
+    stderrWriteEnd.close();
+
+    auto stdinWriter = std::optional<PipeWriter<boost::asio::posix::stream_descriptor>>{};
+    auto stdoutReader = PipeReader{stdoutReadEnd, outputCheckers.output};
+    auto stderrReader = PipeReader{stderrReadEnd, outputCheckers.errorOutput};
+    if (stdinWriteEnd.has_value()) {
+        stdinWriter.emplace(stdinWriteEnd.value(), input.text.value());
+        stdinWriter->write();
+    }
+    stdoutReader.read();
+    stderrReader.read();
+    ios.run();
+
+    auto result = PipelineResult{};
+    for (auto& process : processes) {
+        const auto [exitCode, terminationSignal, resourceUsage] = waitForProcess(process, startTime, cancellation);
+        result.stages.push_back(
+                {.exitCode = exitCode,
+                 .output = {},
+                 .errorOutput = {},
+                 .resourceUsage = resourceUsage,
+                 .terminationSignal = terminationSignal});
+    }
+    result.duration =
+            std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime);
+
+    outputCheckers.output.close();
+    outputCheckers.errorOutput.close();
+    return result;
 }
+#endif
 
 std::string generateLaunchFailureReport(
         std::string_view command,
         const LaunchProcessResult& result,
-        const std::set<ProcessResultCheckMode>& checkModeSet)
+        const OutputCheckers& outputCheckers,
+        const std::optional<PerformanceMeasurement>& performance,
+        const std::set<ProcessResultCheckMode>& checkModeSet,
+        const ProcessLimits& limits)
 {
-    auto expectedResult = ExpectedLaunchProcessResult{};
-    const auto updateExpectedResult = makeCheckModeVisitorSettingExpectedResult(expectedResult);
-    for (const auto& checkMode : checkModeSet)
-        std::visit(updateExpectedResult, checkMode.value);
-
     auto report = fmt::format("-Command: {}\n", command);
 
+    const auto& usage = result.resourceUsage;
+
     report += fmt::format("-Exit code: {}\n", result.exitCode);
-    if (expectedResult.exitCode.has_value())
-        report += fmt::format("-Expected exit code: {}\n", expectedResult.exitCode.value());
+    const auto exitCode = findCheckMode<ProcessResultCheckMode::ExitCode>(checkModeSet);
+    if (exitCode && exitCode->value.has_value())
+        report += fmt::format("-Expected exit code: {}\n", exitCode->value.value());
+    if (result.terminationSignal.has_value())
+        report += fmt::format("-Killed by signal: {}\n", result.terminationSignal.value());
+    if (hasProcessLimits(limits))
+        report += fmt::format("-Limits: {}\n", processLimitsString(limits));
 
-    report += fmt::format("-Output:\n{}---\n", result.output.empty() ? "" : result.output + "\n");
-    if (expectedResult.output.has_value())
+    report += fmt::format("-Duration: {} ms\n", usage.wallTime.count());
+    if (const auto maxDuration = findCheckMode<ProcessResultCheckMode::MaxDuration>(checkModeSet))
+        report += fmt::format("-Expected duration below: {} ms\n", maxDuration->value.count());
+    report += fmt::format(
+            "-CPU time: {} ms user, {} ms system\n",
+            usage.userCpuTime.count(),
+            usage.systemCpuTime.count());
+    report += fmt::format("-Max memory: {}\n", dataSizeString(usage.maxResidentSetSize));
+    if (const auto maxMemory = findCheckMode<ProcessResultCheckMode::MaxMemory>(checkModeSet))
+        report += fmt::format("-Expected max memory: {}\n", dataSizeString(maxMemory->value));
+    report += fmt::format("-I/O blocks: {} input, {} output\n", usage.inputBlocks, usage.outputBlocks);
+    const auto baseline = findCheckMode<ProcessResultCheckMode::PerformanceBaseline>(checkModeSet);
+    if (baseline && performance.has_value()) {
+        const auto statsString = [&](const PerformanceStats& stats)
+        {
+            return fmt::format(
+                    "median {}, MAD {}",
+                    performanceValueString(baseline->metric, stats.median),
+                    performanceValueString(baseline->metric, stats.medianAbsoluteDeviation));
+        };
         report += fmt::format(
-                "-Expected output:\n{}---\n",
-                expectedResult.output.value().empty() ? "" : expectedResult.output.value() + "\n");
+                "-Performance {} over {} repetitions: {}\n",
+                performanceMetricName(baseline->metric),
+                baseline->repetitions,
+                statsString(performance->stats));
+        if (performance->baselineStats.has_value())
+            report += fmt::format(
+                    "-Expected performance {}: {}, tolerance {}%\n",
+                    performanceMetricName(baseline->metric),
+                    statsString(performance->baselineStats.value()),
+                    baseline->tolerancePercent);
+    }
 
-    report += fmt::format("-Error output:\n{}---\n", result.errorOutput.empty() ? "" : result.errorOutput + "\n");
-    if (expectedResult.errorOutput.has_value())
+    report += outputCheckers.output.makeReport("Output");
+    report += outputCheckers.errorOutput.makeReport("Error output");
+    return report;
+}
+
+#ifndef _WIN32
+std::string generatePipelineFailureReport(
+        std::string_view command,
+        const std::vector<PipelineStage>& stages,
+        const PipelineResult& result,
+        const OutputCheckers& outputCheckers,
+        const std::set<ProcessResultCheckMode>& checkModeSet,
+        const std::vector<std::optional<int>>& expectedExitCodes,
+        const ProcessLimits& limits)
+{
+    auto report = fmt::format("-Pipeline: {}\n", command);
+    if (hasProcessLimits(limits))
+        report += fmt::format("-Limits: {}\n", processLimitsString(limits));
+    report += fmt::format("-Duration: {} ms\n", result.duration.count());
+    if (const auto maxDuration = findCheckMode<ProcessResultCheckMode::MaxDuration>(checkModeSet))
+        report += fmt::format("-Expected duration below: {} ms\n", maxDuration->value.count());
+
+    const auto maxMemory = findCheckMode<ProcessResultCheckMode::MaxMemory>(checkModeSet);
+    for (const auto& [stageIndex, stage] : views::enumerate(stages)) {
+        const auto& stageResult = result.stages.at(stageIndex);
+        const auto& usage = stageResult.resourceUsage;
+        report += fmt::format(
+                "-Stage {}: {}\n",
+                stageIndex + 1,
+                stage.cmd.string() + " " + sfun::join(stage.args, " "));
+        report += fmt::format("-Exit code: {}\n", stageResult.exitCode);
+        if (const auto& exitCode = expectedExitCodes.at(stageIndex))
+            report += fmt::format("-Expected exit code: {}\n", exitCode.value());
+        if (stageResult.terminationSignal.has_value())
+            report += fmt::format("-Killed by signal: {}\n", stageResult.terminationSignal.value());
         report += fmt::format(
-                "-Expected error output:\n{}---\n",
-                expectedResult.errorOutput.value().empty() ? "" : expectedResult.errorOutput.value() + "\n");
+                "-CPU time: {} ms user, {} ms system\n",
+                usage.userCpuTime.count(),
+                usage.systemCpuTime.count());
+        report += fmt::format("-Max memory: {}\n", dataSizeString(usage.maxResidentSetSize));
+        if (maxMemory)
+            report += fmt::format("-Expected max memory: {}\n", dataSizeString(maxMemory->value));
+        report += fmt::format("-I/O blocks: {} input, {} output\n", usage.inputBlocks, usage.outputBlocks);
+    }
 
+    report += outputCheckers.output.makeReport("Output");
+    report += outputCheckers.errorOutput.makeReport("Error output");
     return report;
 }
+#endif
 
 } //namespace
 
@@ -254,7 +909,41 @@ LaunchProcessResult runCommand(const std::string& command)
         return {};
 
     const auto cmd = proc::search_path(cmdParts.at(0));
-    return startProcess(cmd, cmdParts | views::drop(1) | ranges::to<std::vector>(), L".");
+    auto outputCheckers = OutputCheckers{};
+    return startProcess(
+            cmd,
+            cmdParts | views::drop(1) | ranges::to<std::vector>(),
+            L".",
+            {},
+            {},
+            outputCheckers,
+            std::nullopt);
+}
+
+LaunchProcessResult runCommand(const std::string& command, const std::string& shellCommand, const fs::path& workingDir)
+{
+    const auto [cmdName, cmdArgs] = parseShellCommand(shellCommand, command);
+    const auto cmd = proc::search_path(cmdName);
+    if (cmd.empty())
+        throw TestConfigError{fmt::format("Couldn't find the executable of a command '{}'", cmdName)};
+
+    auto outputCheckers = OutputCheckers{};
+    return startProcess(cmd, cmdArgs, workingDir, {}, {}, outputCheckers, std::nullopt);
+}
+
+void terminateDetachedProcesses(std::vector<boost::process::child>& detachedProcessList)
+{
+    for (auto& detachedProcess : detachedProcessList)
+        while (detachedProcess.running()) {
+#ifndef _WIN32
+            auto errorCode = std::error_code{};
+            detachedProcess.terminate(errorCode);
+#else
+            const auto id = detachedProcess.id();
+            detachedProcess.detach();
+            runCommand(fmt::format("taskkill /f /t /pid {}", id));
+#endif
+        }
 }
 
 TestActionResult LaunchProcess::operator()() const
@@ -268,32 +957,198 @@ TestActionResult LaunchProcess::operator()() const
     if (cmd.empty())
         throw TestConfigError{fmt::format("Couldn't find the executable of a command '{}'", cmdName)};
 
+    if (input_.file.has_value() && !fs::exists(input_.file.value()))
+        throw TestConfigError{fmt::format(
+                "Input file '{}' of the launched process doesn't exist",
+                homePathString(input_.file.value()))};
+
     if (detachedProcessList_.get().has_value()) {
-        auto process = startDetachedProcess(cmd, cmdArgs, workingDir_);
+        if (input_.text.has_value())
+            throw TestConfigError{"Detached process can't read the input text, use the input file instead"};
+        auto process = startDetachedProcess(cmd, cmdArgs, workingDir_, limits_, input_.file);
         if (!process.valid())
             throw TestConfigError{fmt::format("Couldn't start the process '{}'", command_)};
         detachedProcessList_.get().value().emplace_back(std::move(process));
         return TestActionResult::Success();
     }
 
-    const auto launchResult = skipReadingOutput_ ? startProcessWithoutReadingOutput(cmd, cmdArgs, workingDir_)
-                                                 : startProcess(cmd, cmdArgs, workingDir_);
+    auto outputCheckers = makeOutputCheckers(checkModeSet_);
+    const auto launchResult = [&]
+    {
+        if (!skipReadingOutput_)
+            return startProcess(cmd, cmdArgs, workingDir_, limits_, input_, outputCheckers, cancellation_.get());
+
+        outputCheckers.output.close();
+        outputCheckers.errorOutput.close();
+        return startProcessWithoutReadingOutput(cmd, cmdArgs, workingDir_, limits_, input_, cancellation_.get());
+    }();
+    const auto writeFailureReport = [&](const std::optional<PerformanceMeasurement>& performance)
+    {
+        auto failureReport = generateLaunchFailureReport(
+                cmd.string() + " " + sfun::join(cmdArgs, " "),
+                launchResult,
+                outputCheckers,
+                performance,
+                checkModeSet_,
+                limits_);
+        auto failureReportFile = std::ofstream{workingDir_ / failureReportFilename(actionIndex_)};
+        failureReportFile << failureReport;
+    };
+
+    // Processes killed for exceeding their limits fail regardless of the result checks
+    const auto exceededLimit = launchResult.terminationSignal.has_value()
+            ? exceededProcessLimit(limits_, launchResult.terminationSignal.value(), launchResult.resourceUsage)
+            : std::nullopt;
+    if (exceededLimit.has_value()) {
+        writeFailureReport(std::nullopt);
+        return TestActionResult::Failure(fmt::format(
+                "Launched process '{}' was killed: {}. More info in {}",
+                command_,
+                exceededLimit.value(),
+                failureReportFilename(actionIndex_)));
+    }
+
     if (checkModeSet_.empty())
         return TestActionResult::Success();
 
+    const auto performance =
+            measurePerformance(cmd, cmdArgs, workingDir_, limits_, input_, checkModeSet_, cancellation_.get());
     for (const auto& checkMode : checkModeSet_) {
-        auto result = std::visit(makeCheckModeVisitor(launchResult, command_, actionIndex_), checkMode.value);
+        auto result = std::visit(
+                makeCheckModeVisitor(launchResult, outputCheckers, performance, command_, actionIndex_),
+                checkMode.value);
         if (!result.isSuccessful()) {
-            auto failureReport = generateLaunchFailureReport(
-                    cmd.string() + " " + sfun::join(cmdArgs, " "),
-                    launchResult,
-                    checkModeSet_);
-            auto failureReportFile = std::ofstream{workingDir_ / failureReportFilename(actionIndex_)};
-            failureReportFile << failureReport;
+            writeFailureReport(performance);
             return result;
         }
     }
     return TestActionResult::Success();
 }
 
+LaunchPipeline::LaunchPipeline(
+        std::string command,
+        fs::path workingDir,
+        std::set<ProcessResultCheckMode> checkModeSet,
+        std::vector<ProcessResultCheckMode::ExitCode> stageExitCodes,
+        int actionIndex,
+        ProcessLimits limits,
+        ProcessInput input,
+        sfun::optional_ref<TestCancellation> cancellation)
+    : command_{std::move(command)}
+    , workingDir_{std::move(workingDir)}
+    , checkModeSet_{std::move(checkModeSet)}
+    , stageExitCodes_{std::move(stageExitCodes)}
+    , actionIndex_{actionIndex}
+    , limits_{limits}
+    , input_{std::move(input)}
+    , cancellation_{cancellation}
+{
+}
+
+TestActionResult LaunchPipeline::operator()() const
+{
+#ifdef _WIN32
+    throw TestConfigError{"Launch pipeline action is only available on POSIX systems"};
+#else
+    const auto stageCommands = splitPipeline(command_);
+    if (std::ssize(stageCommands) < 2)
+        throw TestConfigError{fmt::format("Pipeline '{}' must have at least two stages", command_)};
+    if (!stageExitCodes_.empty() && stageExitCodes_.size() != stageCommands.size())
+        throw TestConfigError{fmt::format(
+                "Pipeline '{}' has {} stages, but {} exit codes are expected",
+                command_,
+                stageCommands.size(),
+                stageExitCodes_.size())};
+
+    const auto currentPath = boost::this_process::path();
+    const auto path = views::concat(currentPath, views::single(sfun::path_string(workingDir_))) |
+            ranges::to<std::vector>;
+    auto stages = std::vector<PipelineStage>{};
+    for (const auto& stageCommand : stageCommands) {
+        const auto [cmdName, cmdArgs] = parseCommand(stageCommand);
+        const auto cmd = proc::search_path(std::string{cmdName}, path);
+        if (cmd.empty())
+            throw TestConfigError{fmt::format("Couldn't find the executable of a command '{}'", cmdName)};
+        stages.push_back({cmd, cmdArgs});
+    }
+    if (input_.file.has_value() && !fs::exists(input_.file.value()))
+        throw TestConfigError{fmt::format(
+                "Input file '{}' of the launched pipeline doesn't exist",
+                homePathString(input_.file.value()))};
+
+    // Without the exit code checks, all stages are expected to succeed
+    const auto expectedExitCodes = stageExitCodes_.empty()
+            ? std::vector<std::optional<int>>(stages.size(), 0)
+            : stageExitCodes_ | views::transform(&ProcessResultCheckMode::ExitCode::value) | ranges::to<std::vector>;
+
+    auto outputCheckers = makeOutputCheckers(checkModeSet_);
+    const auto pipelineResult =
+            startPipeline(stages, workingDir_, limits_, input_, outputCheckers, cancellation_.get());
+    const auto failure = [&](const std::string& message)
+    {
+        auto failureReportFile = std::ofstream{workingDir_ / failureReportFilename(actionIndex_)};
+        failureReportFile << generatePipelineFailureReport(
+                command_,
+                stages,
+                pipelineResult,
+                outputCheckers,
+                checkModeSet_,
+                expectedExitCodes,
+                limits_);
+        return TestActionResult::Failure(
+                fmt::format("{}. More info in {}", message, failureReportFilename(actionIndex_)));
+    };
+
+    for (const auto& [stageIndex, stageResult] : views::enumerate(pipelineResult.stages)) {
+        const auto& stageCommand = stageCommands.at(stageIndex);
+        // Processes killed for exceeding their limits fail regardless of the result checks
+        const auto exceededLimit = stageResult.terminationSignal.has_value()
+                ? exceededProcessLimit(limits_, stageResult.terminationSignal.value(), stageResult.resourceUsage)
+                : std::nullopt;
+        if (exceededLimit.has_value())
+            return failure(fmt::format(
+                    "Launched pipeline stage {} '{}' was killed: {}",
+                    stageIndex + 1,
+                    stageCommand,
+                    exceededLimit.value()));
+
+        const auto& expectedExitCode = expectedExitCodes.at(stageIndex);
+        if (expectedExitCode.has_value() && stageResult.terminationSignal.has_value())
+            return failure(fmt::format(
+                    "Launched pipeline stage {} '{}' was killed by signal {}",
+                    stageIndex + 1,
+                    stageCommand,
+                    stageResult.terminationSignal.value()));
+        if (expectedExitCode.has_value() && stageResult.exitCode != expectedExitCode.value())
+            return failure(fmt::format(
+                    "Launched pipeline stage {} '{}' returned unexpected exit code {}",
+                    stageIndex + 1,
+                    stageCommand,
+                    stageResult.exitCode));
+
+        const auto maxMemory = findCheckMode<ProcessResultCheckMode::MaxMemory>(checkModeSet_);
+        if (maxMemory && stageResult.resourceUsage.maxResidentSetSize > maxMemory->value)
+            return failure(fmt::format(
+                    "Launched pipeline stage {} '{}' used {} of memory, exceeding the limit of {}",
+                    stageIndex + 1,
+                    stageCommand,
+                    dataSizeString(stageResult.resourceUsage.maxResidentSetSize),
+                    dataSizeString(maxMemory->value)));
+    }
+
+    const auto maxDuration = findCheckMode<ProcessResultCheckMode::MaxDuration>(checkModeSet_);
+    if (maxDuration && pipelineResult.duration > maxDuration->value)
+        return failure(fmt::format(
+                "Launched pipeline '{}' took {} ms, exceeding the limit of {} ms",
+                command_,
+                pipelineResult.duration.count(),
+                maxDuration->value.count()));
+    if (findCheckMode<ProcessResultCheckMode::Output>(checkModeSet_) && !outputCheckers.output.isSuccessful())
+        return failure(fmt::format("Launched pipeline '{}' returned unexpected output", command_));
+    if (findCheckMode<ProcessResultCheckMode::ErrorOutput>(checkModeSet_) && !outputCheckers.errorOutput.isSuccessful())
+        return failure(fmt::format("Launched pipeline '{}' returned unexpected error output", command_));
+    return TestActionResult::Success();
+#endif
+}
+
 } //namespace lunchtoast
\ No newline at end of file
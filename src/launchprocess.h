@@ -1,6 +1,8 @@
 #pragma once
 #include "launchprocessresult.h"
+#include "processlimits.h"
 #include "processresultcheckmode.h"
+#include "testcancellation.h"
 #include "testactionresult.h"
 #include <sfun/optional_ref.h>
 #include <boost/process/child.hpp>
@@ -9,12 +11,25 @@
 #include <optional>
 #include <set>
 #include <string>
+#include <vector>
 
 namespace lunchtoast {
 
 class TestAction;
 
+// Standard input of the launched process: the text is written to the process through a pipe,
+// the file is opened as the process stdin, so its contents aren't copied by lunchtoast
+struct ProcessInput {
+    std::optional<std::string> text;
+    std::optional<std::filesystem::path> file;
+};
+
 LaunchProcessResult runCommand(const std::string& cmd);
+LaunchProcessResult runCommand(
+        const std::string& command,
+        const std::string& shellCommand,
+        const std::filesystem::path& workingDir);
+void terminateDetachedProcesses(std::vector<boost::process::child>& detachedProcessList);
 
 class LaunchProcess {
 public:
@@ -25,7 +40,10 @@ public:
             std::set<ProcessResultCheckMode> checkModeSet,
             int actionIndex,
             sfun::optional_ref<std::vector<boost::process::child>> detachedProcessList = std::nullopt,
-            bool skipReadingOutput = false);
+            bool skipReadingOutput = false,
+            ProcessLimits limits = {},
+            ProcessInput input = {},
+            sfun::optional_ref<TestCancellation> cancellation = std::nullopt);
     TestActionResult operator()() const;
 
 private:
@@ -36,6 +54,36 @@ private:
     int actionIndex_;
     sfun::member<sfun::optional_ref<std::vector<boost::process::child>>> detachedProcessList_;
     bool skipReadingOutput_;
+    ProcessLimits limits_;
+    ProcessInput input_;
+    sfun::member<sfun::optional_ref<TestCancellation>> cancellation_;
+};
+
+// Launches the stages of the pipeline without a shell, connecting the output of each stage to the input of the
+// next one. Output checks are applied to the output of the last stage and to the error output of all stages,
+// exit codes and used memory are checked for each stage.
+class LaunchPipeline {
+public:
+    LaunchPipeline(
+            std::string command,
+            std::filesystem::path workingDir,
+            std::set<ProcessResultCheckMode> checkModeSet,
+            std::vector<ProcessResultCheckMode::ExitCode> stageExitCodes,
+            int actionIndex,
+            ProcessLimits limits = {},
+            ProcessInput input = {},
+            sfun::optional_ref<TestCancellation> cancellation = std::nullopt);
+    TestActionResult operator()() const;
+
+private:
+    std::string command_;
+    std::filesystem::path workingDir_;
+    std::set<ProcessResultCheckMode> checkModeSet_;
+    std::vector<ProcessResultCheckMode::ExitCode> stageExitCodes_;
+    int actionIndex_;
+    ProcessLimits limits_;
+    ProcessInput input_;
+    sfun::member<sfun::optional_ref<TestCancellation>> cancellation_;
 };
 
 } //namespace lunchtoast
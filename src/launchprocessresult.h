@@ -1,12 +1,26 @@
 #pragma once
+#include <chrono>
+#include <cstdint>
+#include <optional>
 #include <string>
 
 namespace lunchtoast {
 
+struct ProcessResourceUsage {
+    std::chrono::milliseconds wallTime{};
+    std::chrono::milliseconds userCpuTime{};
+    std::chrono::milliseconds systemCpuTime{};
+    std::int64_t maxResidentSetSize = 0;
+    std::int64_t inputBlocks = 0;
+    std::int64_t outputBlocks = 0;
+};
+
 struct LaunchProcessResult {
     int exitCode;
     std::string output;
     std::string errorOutput;
+    ProcessResourceUsage resourceUsage;
+    std::optional<int> terminationSignal = std::nullopt;
 };
 
 } //namespace lunchtoast
@@ -1,13 +1,17 @@
 #include "commandline.h"
 #include "config.h"
 #include "constants.h"
+#include "daemon.h"
+#include "shardresults.h"
 #include "test.h"
 #include "testcontentsgenerator.h"
 #include "testlauncher.h"
 #include "testreporter.h"
+#include "utils.h"
 #include <cmdlime/commandlinereader.h>
 #include <figcone/configreader.h>
 #include <fmt/format.h>
+#include <csignal>
 #include <filesystem>
 #include <optional>
 
@@ -15,18 +19,34 @@ using namespace lunchtoast;
 namespace fs = std::filesystem;
 
 int generateTestContents(const CommandSaveContents& commandCfg);
+int mergeTestResults(const CommandMergeResults& commandCfg);
+int runDaemonClient(const CommandClient& commandCfg);
+int serveDaemonRequests(const CommandLine& commandLine, const Config& cfg);
 Config readConfig(const CommandLine& commandLine);
 
 int mainApp(const CommandLine& commandLine)
 {
     if (commandLine.saveContents.has_value())
         return generateTestContents(commandLine.saveContents.value());
+    if (commandLine.mergeResults.has_value())
+        return mergeTestResults(commandLine.mergeResults.value());
+    if (commandLine.client.has_value())
+        return runDaemonClient(commandLine.client.value());
 
     const auto cfg = readConfig(commandLine);
     try {
-        const auto testReporter = TestReporter{commandLine.reportFile, commandLine.reportWidth};
+        if (!commandLine.daemonSocket.empty())
+            return serveDaemonRequests(commandLine, cfg);
+
+        const auto testReporter = TestReporter{
+                commandLine.reportFile,
+                commandLine.reportWidth,
+                commandLine.showProgress,
+                commandLine.watch};
         auto testLauncher = TestLauncher{testReporter, commandLine, cfg};
         const auto allTestPassed = testLauncher.process();
+        if (commandLine.watch)
+            testLauncher.watch();
         return allTestPassed ? 0 : 1;
     }
     catch (const std::runtime_error& e) {
@@ -50,6 +70,8 @@ int wmain(int argc, wchar_t** argv)
 #else
 int main(int argc, char** argv)
 {
+    // Writing the input of a process that exited without reading it must fail instead of terminating lunchtoast
+    std::signal(SIGPIPE, SIG_IGN);
     auto cmdlineReader =
             cmdlime::CommandLineReader<cmdlime::Format::Simple>{"lunchtoast", std::string{hardcoded::appVersion}};
     cmdlineReader.setErrorOutputStream(std::cout);
@@ -71,6 +93,59 @@ int generateTestContents(const CommandSaveContents& commandCfg)
     }
 }
 
+int mergeTestResults(const CommandMergeResults& commandCfg)
+{
+    try {
+        auto results = ShardResults{};
+        for (const auto& resultFile : commandCfg.resultFiles)
+            mergeShardResults(results, readShardResults(resultFile));
+
+        const auto testReporter = TestReporter{commandCfg.reportFile, commandCfg.reportWidth, false, false};
+        testReporter.reportSummary(results.defaultSuite, results.suites);
+
+        const auto failedTests = failedTestList(results);
+        if (!commandCfg.listFailedTests.empty())
+            writePathList(failedTests, commandCfg.listFailedTests);
+        if (!commandCfg.testDurations.empty())
+            writeTestDurations(results.testDurations, commandCfg.testDurations);
+        return failedTests.empty() ? 0 : 1;
+    }
+    catch (const std::runtime_error& e) {
+        fmt::print(fmt::runtime(e.what()));
+        return 2;
+    }
+}
+
+int runDaemonClient(const CommandClient& commandCfg)
+{
+    try {
+        return sendDaemonRequest(
+                commandCfg.socket,
+                DaemonRequest{
+                        .testPaths = commandCfg.testPaths,
+                        .selectedTags = commandCfg.select,
+                        .skippedTags = commandCfg.skip});
+    }
+    catch (const std::runtime_error& e) {
+        fmt::print(fmt::runtime(e.what()));
+        return 2;
+    }
+}
+
+int serveDaemonRequests(const CommandLine& commandLine, const Config& cfg)
+{
+    auto daemon = Daemon{commandLine.daemonSocket};
+    const auto testReporter = TestReporter{
+            [&daemon](std::string_view text)
+            {
+                daemon.writeOutput(text);
+            },
+            commandLine.reportWidth};
+    auto testLauncher = TestLauncher{testReporter, commandLine, cfg};
+    daemon.serve(testLauncher);
+    return 0;
+}
+
 Config readConfig(const CommandLine& commandLine)
 {
     if (!commandLine.config.empty()) {
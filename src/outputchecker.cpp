@@ -0,0 +1,292 @@
+#include "outputchecker.h"
+#include "constants.h"
+#include "textdiff.h"
+#include "utils.h"
+#include <fmt/format.h>
+#include <sfun/contract.h>
+#include <algorithm>
+#include <utility>
+
+namespace lunchtoast {
+
+namespace {
+
+std::vector<std::string> splitLines(std::string_view text)
+{
+    auto result = std::vector<std::string>{};
+    while (!text.empty()) {
+        const auto lineBreakPos = text.find('\n');
+        result.emplace_back(text.substr(0, lineBreakPos));
+        if (lineBreakPos == std::string_view::npos)
+            break;
+        text.remove_prefix(lineBreakPos + 1);
+    }
+    return result;
+}
+
+std::string joinLines(const std::vector<std::string>& lines)
+{
+    auto result = std::string{};
+    for (const auto& line : lines)
+        result += line + "\n";
+    return result;
+}
+
+std::string expectedTextTitle(OutputCheckType checkType, std::string_view textName)
+{
+    switch (checkType) {
+    case OutputCheckType::Contains:
+        return fmt::format("Expected {} to contain", toLower(textName));
+    case OutputCheckType::MatchesLines:
+        return fmt::format("Expected {} line patterns", toLower(textName));
+    case OutputCheckType::LineSetEqual:
+        return fmt::format("Expected {} line set", toLower(textName));
+    default:
+        return fmt::format("Expected {}", toLower(textName));
+    }
+}
+
+} //namespace
+
+OutputChecker::OutputChecker(
+        OutputCheckType checkType,
+        const std::string& expectedOutput,
+        const std::optional<std::string>& ignoredLinesPattern)
+    : checkType_{checkType}
+    , expectedOutput_{normalizeLineEndings(expectedOutput)}
+    , ignoredLinesPattern_{ignoredLinesPattern}
+{
+    if (ignoredLinesPattern_.has_value())
+        ignoredLinesRegex_ = std::regex{ignoredLinesPattern_.value()};
+
+    const auto isLineIgnored = [this](const std::string& line)
+    {
+        return ignoredLinesRegex_.has_value() && std::regex_match(line, ignoredLinesRegex_.value());
+    };
+
+    switch (checkType) {
+    case OutputCheckType::Equal:
+        if (ignoredLinesRegex_.has_value()) {
+            auto lines = splitLines(expectedOutput_);
+            std::erase_if(lines, isLineIgnored);
+            const auto hasLastLineBreak = expectedOutput_.ends_with('\n');
+            expectedOutput_ = joinLines(lines);
+            if (!hasLastLineBreak && !expectedOutput_.empty())
+                expectedOutput_.pop_back();
+        }
+        break;
+    case OutputCheckType::Contains:
+        isCheckFinished_ = expectedOutput_.empty();
+        break;
+    case OutputCheckType::MatchesLines:
+        for (const auto& line : splitLines(expectedOutput_))
+            expectedLineRegexList_.emplace_back(line);
+        break;
+    case OutputCheckType::LineSetEqual:
+        for (auto& line : splitLines(expectedOutput_))
+            if (!isLineIgnored(line))
+                expectedLineSet_.emplace(std::move(line));
+        break;
+    }
+}
+
+void OutputChecker::write(std::string_view data)
+{
+    sfun_precondition(!isClosed_);
+
+    if (!hasPendingCarriageReturn_ && data.find('\r') == std::string_view::npos) {
+        processNormalizedData(data);
+        return;
+    }
+
+    auto normalizedData = std::string{};
+    normalizedData.reserve(data.size());
+    for (auto ch : data) {
+        if (std::exchange(hasPendingCarriageReturn_, false) && ch == '\n')
+            continue;
+        if (ch == '\r') {
+            hasPendingCarriageReturn_ = true;
+            ch = '\n';
+        }
+        normalizedData.push_back(ch);
+    }
+    processNormalizedData(normalizedData);
+}
+
+void OutputChecker::close()
+{
+    if (std::exchange(isClosed_, true))
+        return;
+
+    if (isProcessingLines() && !currentLine_.empty() && !isCheckFinished_)
+        processLine(currentLine_);
+    currentLine_.clear();
+    if (!checkType_.has_value() || isCheckFinished_)
+        return;
+
+    switch (checkType_.value()) {
+    case OutputCheckType::Equal:
+        isSuccessful_ = (capturedOutput_ == expectedOutput_);
+        break;
+    case OutputCheckType::Contains:
+        fail("the expected text wasn't found");
+        break;
+    case OutputCheckType::MatchesLines:
+        if (lineCount_ < std::ssize(expectedLineRegexList_))
+            fail(fmt::format(
+                    "the text has {} lines, {} lines were expected",
+                    lineCount_,
+                    expectedLineRegexList_.size()));
+        break;
+    case OutputCheckType::LineSetEqual: {
+        const auto missingLineIt = std::ranges::find_if(
+                expectedLineSet_,
+                [this](const std::string& line)
+                {
+                    return !foundLineSet_.contains(line);
+                });
+        if (missingLineIt != expectedLineSet_.end())
+            fail(fmt::format("the line '{}' wasn't found", *missingLineIt));
+        break;
+    }
+    }
+}
+
+bool OutputChecker::isSuccessful() const
+{
+    sfun_precondition(isClosed_);
+    return isSuccessful_;
+}
+
+std::string_view OutputChecker::output() const
+{
+    return capturedOutput_;
+}
+
+std::string OutputChecker::makeReport(std::string_view textName) const
+{
+    auto report = std::string{};
+    if (ignoredLinesPattern_.has_value())
+        report += fmt::format("-Ignored {} lines: {}\n", toLower(textName), ignoredLinesPattern_.value());
+
+    if (checkType_ == OutputCheckType::Equal && !isSuccessful_)
+        return report + makeTextMismatchReport(textName, capturedOutput_, expectedOutput_);
+
+    if (isCapturedOutputTruncated_)
+        report += fmt::format("-{} (first {} bytes):\n{}\n---\n", textName, capturedOutput_.size(), capturedOutput_);
+    else
+        report += fmt::format("-{}:\n{}---\n", textName, capturedOutput_.empty() ? "" : capturedOutput_ + "\n");
+
+    if (!checkType_.has_value() || checkType_ == OutputCheckType::Equal)
+        return report;
+
+    report += fmt::format(
+            "-{}:\n{}---\n",
+            expectedTextTitle(checkType_.value(), textName),
+            expectedOutput_.empty() ? "" : expectedOutput_ + "\n");
+    if (!isSuccessful_)
+        report += fmt::format("-{} check failure: {}\n", textName, failureReason_);
+    return report;
+}
+
+bool OutputChecker::isProcessingLines() const
+{
+    return ignoredLinesRegex_.has_value() || checkType_ == OutputCheckType::MatchesLines ||
+            checkType_ == OutputCheckType::LineSetEqual;
+}
+
+void OutputChecker::processNormalizedData(std::string_view data)
+{
+    // The whole output is stored only when it's needed for the equality check or the failure report,
+    // other checks keep the beginning of the output for the report and process the rest on the fly
+    const auto isCapturingWholeOutput = !checkType_.has_value() ||
+            (checkType_ == OutputCheckType::Equal && !ignoredLinesRegex_.has_value());
+    if (isCapturingWholeOutput) {
+        capturedOutput_ += data;
+        return;
+    }
+    if (checkType_ != OutputCheckType::Equal) {
+        const auto capturedSize = std::min<std::ptrdiff_t>(
+                std::ssize(data),
+                hardcoded::failureReportMaxTextSize - std::ssize(capturedOutput_));
+        capturedOutput_ += data.substr(0, capturedSize);
+        if (capturedSize < std::ssize(data))
+            isCapturedOutputTruncated_ = true;
+    }
+
+    if (isCheckFinished_)
+        return;
+    if (!isProcessingLines()) {
+        processText(data);
+        return;
+    }
+
+    auto lineBreakPos = data.find('\n');
+    while (lineBreakPos != std::string_view::npos && !isCheckFinished_) {
+        currentLine_ += data.substr(0, lineBreakPos);
+        data.remove_prefix(lineBreakPos + 1);
+        processLine(currentLine_);
+        currentLine_.clear();
+        lineBreakPos = data.find('\n');
+    }
+    if (!isCheckFinished_)
+        currentLine_ += data;
+}
+
+void OutputChecker::processText(std::string_view text)
+{
+    if (checkType_ == OutputCheckType::Equal) {
+        capturedOutput_ += text;
+        return;
+    }
+
+    // Only the tail that can be a beginning of the expected text is kept between the calls
+    searchWindow_ += text;
+    if (searchWindow_.find(expectedOutput_) != std::string::npos) {
+        isCheckFinished_ = true;
+        searchWindow_.clear();
+        return;
+    }
+    const auto keptSize = std::min(searchWindow_.size(), expectedOutput_.size() - 1);
+    searchWindow_.erase(0, searchWindow_.size() - keptSize);
+}
+
+void OutputChecker::processLine(std::string_view line)
+{
+    const auto isLastLine = isClosed_;
+    if (ignoredLinesRegex_.has_value() && std::regex_match(line.begin(), line.end(), ignoredLinesRegex_.value()))
+        return;
+
+    switch (checkType_.value()) {
+    case OutputCheckType::Equal:
+    case OutputCheckType::Contains:
+        processText(std::string{line} + (isLastLine ? "" : "\n"));
+        break;
+    case OutputCheckType::MatchesLines:
+        if (lineCount_ >= std::ssize(expectedLineRegexList_))
+            fail(fmt::format("unexpected line {}: '{}'", lineCount_ + 1, line));
+        else if (!std::regex_match(line.begin(), line.end(), expectedLineRegexList_.at(lineCount_)))
+            fail(fmt::format(
+                    "the line {} '{}' doesn't match the pattern '{}'",
+                    lineCount_ + 1,
+                    line,
+                    splitLines(expectedOutput_).at(lineCount_)));
+        ++lineCount_;
+        break;
+    case OutputCheckType::LineSetEqual:
+        if (!expectedLineSet_.contains(line))
+            fail(fmt::format("unexpected line '{}'", line));
+        else
+            foundLineSet_.emplace(line);
+        break;
+    }
+}
+
+void OutputChecker::fail(std::string reason)
+{
+    isSuccessful_ = false;
+    isCheckFinished_ = true;
+    failureReason_ = std::move(reason);
+}
+
+} //namespace lunchtoast
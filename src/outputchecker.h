@@ -0,0 +1,55 @@
+#pragma once
+#include "processresultcheckmode.h"
+#include <optional>
+#include <regex>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace lunchtoast {
+
+class OutputChecker {
+public:
+    OutputChecker() = default;
+    OutputChecker(
+            OutputCheckType checkType,
+            const std::string& expectedOutput,
+            const std::optional<std::string>& ignoredLinesPattern);
+
+    void write(std::string_view data);
+    void close();
+
+    bool isSuccessful() const;
+    std::string_view output() const;
+    std::string makeReport(std::string_view textName) const;
+
+private:
+    bool isProcessingLines() const;
+    void processNormalizedData(std::string_view data);
+    void processText(std::string_view text);
+    void processLine(std::string_view line);
+    void fail(std::string reason);
+
+private:
+    std::optional<OutputCheckType> checkType_;
+    std::string expectedOutput_;
+    std::optional<std::regex> ignoredLinesRegex_;
+    std::optional<std::string> ignoredLinesPattern_;
+    std::vector<std::regex> expectedLineRegexList_;
+    std::set<std::string, std::less<>> expectedLineSet_;
+    std::set<std::string, std::less<>> foundLineSet_;
+
+    std::string capturedOutput_;
+    bool isCapturedOutputTruncated_ = false;
+    std::string currentLine_;
+    std::string searchWindow_;
+    bool hasPendingCarriageReturn_ = false;
+    int lineCount_ = 0;
+    bool isCheckFinished_ = false;
+    bool isClosed_ = false;
+    bool isSuccessful_ = true;
+    std::string failureReason_;
+};
+
+} //namespace lunchtoast
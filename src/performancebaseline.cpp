@@ -0,0 +1,83 @@
+#include "performancebaseline.h"
+#include <fmt/format.h>
+#include <sfun/contract.h>
+#include <sfun/path.h>
+#include <sfun/string_utils.h>
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+namespace lunchtoast {
+namespace fs = std::filesystem;
+
+namespace {
+std::int64_t median(std::vector<std::int64_t>& values)
+{
+    const auto middle = values.begin() + std::ssize(values) / 2;
+    std::ranges::nth_element(values, middle);
+    if (values.size() % 2 == 1)
+        return *middle;
+    const auto lowerMiddle = *std::max_element(values.begin(), middle);
+    return lowerMiddle + (*middle - lowerMiddle) / 2;
+}
+} //namespace
+
+PerformanceStats calculatePerformanceStats(std::vector<std::int64_t> values)
+{
+    sfun_precondition(!values.empty());
+
+    const auto valuesMedian = median(values);
+    for (auto& value : values)
+        value = std::abs(value - valuesMedian);
+    return {.median = valuesMedian, .medianAbsoluteDeviation = median(values)};
+}
+
+bool exceedsPerformanceBaseline(
+        const PerformanceStats& stats,
+        const PerformanceStats& baseline,
+        double tolerancePercent)
+{
+    const auto allowedMedian = static_cast<double>(baseline.median) * (1 + tolerancePercent / 100) +
+            3 * static_cast<double>(baseline.medianAbsoluteDeviation);
+    return static_cast<double>(stats.median) > allowedMedian;
+}
+
+std::optional<PerformanceStats> readPerformanceBaseline(const fs::path& filePath)
+{
+    if (!fs::exists(filePath))
+        return std::nullopt;
+
+    auto result = PerformanceStats{};
+    auto stream = std::ifstream{filePath};
+    auto line = std::string{};
+    while (std::getline(stream, line)) {
+        const auto name = sfun::before(line, ":");
+        const auto value = sfun::after(line, ":");
+        if (!name.has_value() || !value.has_value())
+            continue;
+        try {
+            if (sfun::trim(name.value()) == "median")
+                result.median = std::stoll(std::string{sfun::trim(value.value())});
+            else if (sfun::trim(name.value()) == "mad")
+                result.medianAbsoluteDeviation = std::stoll(std::string{sfun::trim(value.value())});
+        }
+        catch (const std::logic_error&) {
+            throw std::runtime_error{fmt::format(
+                    "Performance baseline file {} contains an invalid line: {}",
+                    sfun::path_string(filePath),
+                    line)};
+        }
+    }
+    return result;
+}
+
+void writePerformanceBaseline(const PerformanceStats& stats, const fs::path& filePath)
+{
+    auto stream = std::ofstream{filePath};
+    stream << "median: " << stats.median << std::endl;
+    stream << "mad: " << stats.medianAbsoluteDeviation << std::endl;
+}
+
+} //namespace lunchtoast
@@ -0,0 +1,24 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <vector>
+
+namespace lunchtoast {
+
+struct PerformanceStats {
+    std::int64_t median = 0;
+    std::int64_t medianAbsoluteDeviation = 0;
+};
+
+PerformanceStats calculatePerformanceStats(std::vector<std::int64_t> values);
+// The median is allowed to exceed the baseline by the tolerance percentage and three median absolute deviations
+// of the baseline, so the measurement noise doesn't fail the check
+bool exceedsPerformanceBaseline(
+        const PerformanceStats& stats,
+        const PerformanceStats& baseline,
+        double tolerancePercent);
+std::optional<PerformanceStats> readPerformanceBaseline(const std::filesystem::path& filePath);
+void writePerformanceBaseline(const PerformanceStats& stats, const std::filesystem::path& filePath);
+
+} //namespace lunchtoast
@@ -0,0 +1,81 @@
+#include "portallocator.h"
+#include "errors.h"
+#include <boost/asio.hpp>
+#include <fmt/format.h>
+#include <algorithm>
+#include <regex>
+#include <stdexcept>
+
+namespace lunchtoast {
+namespace asio = boost::asio;
+
+namespace {
+constexpr auto maxAcquiredPortCollisions = 100;
+}
+
+std::vector<int> PortAllocator::acquirePorts(int count)
+{
+    // The system picks a free port for a socket bound to the port 0. The sockets are kept open until
+    // all ports are found, so the same port isn't returned twice, and the ports acquired by other tests
+    // that aren't listened to yet are skipped.
+    auto ioContext = asio::io_context{};
+    auto acceptors = std::vector<asio::ip::tcp::acceptor>{};
+    auto result = std::vector<int>{};
+    auto lock = std::scoped_lock{mutex_};
+    auto collisionsCount = 0;
+    while (std::ssize(result) < count) {
+        auto& acceptor = acceptors.emplace_back(ioContext);
+        const auto endpoint = asio::ip::tcp::endpoint{asio::ip::address_v4::loopback(), 0};
+        acceptor.open(endpoint.protocol());
+        acceptor.bind(endpoint);
+        const auto port = static_cast<int>(acceptor.local_endpoint().port());
+        if (acquiredPorts_.contains(port)) {
+            // Only collisions with the acquired ports are limited, so a test can use any number of ports
+            if (++collisionsCount == maxAcquiredPortCollisions)
+                throw std::runtime_error{fmt::format("Can't find {} free localhost ports", count)};
+            continue;
+        }
+        acquiredPorts_.insert(port);
+        result.push_back(port);
+    }
+    return result;
+}
+
+void PortAllocator::releasePorts(const std::vector<int>& ports)
+{
+    auto lock = std::scoped_lock{mutex_};
+    for (const auto port : ports)
+        acquiredPorts_.erase(port);
+}
+
+AllocatedPorts::AllocatedPorts(PortAllocator& portAllocator, int count)
+    : portAllocator_{portAllocator}
+    , ports_{portAllocator.acquirePorts(count)}
+{
+}
+
+AllocatedPorts::~AllocatedPorts()
+{
+    portAllocator_.get().releasePorts(ports_);
+}
+
+const std::vector<int>& AllocatedPorts::ports() const
+{
+    return ports_;
+}
+
+int maxPortVariableIndex(const std::string& value)
+{
+    static const auto format = std::regex{R"(\$\{\{\s*PORT_(\d+)\s*\}\})"};
+    auto result = 0;
+    for (auto it = std::sregex_iterator{value.begin(), value.end(), format}; it != std::sregex_iterator{}; ++it)
+        try {
+            result = std::max(result, std::stoi((*it)[1].str()));
+        }
+        catch (const std::out_of_range&) {
+            throw TestConfigError{fmt::format("Invalid port variable '{}'", (*it)[0].str())};
+        }
+    return result;
+}
+
+} //namespace lunchtoast
@@ -0,0 +1,40 @@
+#pragma once
+#include <sfun/member.h>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace lunchtoast {
+
+// Finds free localhost ports for the PORT_<n> variables of tests.
+// Ports are shared by all tests of the run, so the tests running at the same time never get the same port.
+class PortAllocator {
+public:
+    std::vector<int> acquirePorts(int count);
+    void releasePorts(const std::vector<int>& ports);
+
+private:
+    std::mutex mutex_;
+    std::set<int> acquiredPorts_;
+};
+
+// Ports acquired for a test and released on its destruction
+class AllocatedPorts {
+public:
+    AllocatedPorts(PortAllocator& portAllocator, int count);
+    ~AllocatedPorts();
+    AllocatedPorts(const AllocatedPorts&) = delete;
+    AllocatedPorts& operator=(const AllocatedPorts&) = delete;
+
+    const std::vector<int>& ports() const;
+
+private:
+    sfun::member<PortAllocator&> portAllocator_;
+    std::vector<int> ports_;
+};
+
+// Returns the largest index n of the ${{ PORT_n }} variables used in the value, or zero when there are none
+int maxPortVariableIndex(const std::string& value);
+
+} //namespace lunchtoast
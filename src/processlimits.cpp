@@ -0,0 +1,155 @@
+#include "processlimits.h"
+#include "errors.h"
+#include "utils.h"
+#include <fmt/format.h>
+#include <sfun/string_utils.h>
+#include <charconv>
+#include <csignal>
+#include <vector>
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+namespace lunchtoast {
+
+namespace {
+std::int64_t readLimitCount(std::string_view limitName, const std::string& value)
+{
+    const auto countStr = sfun::trim(value);
+    auto count = std::int64_t{};
+    const auto [end, error] = std::from_chars(countStr.data(), countStr.data() + countStr.size(), count);
+    if (error != std::errc{} || end != countStr.data() + countStr.size() || count <= 0)
+        throw TestConfigError{
+                fmt::format("Invalid {} limit '{}', value must be a positive number", limitName, value)};
+    return count;
+}
+
+std::string limitSizeString(std::int64_t size)
+{
+    const auto units = std::vector<std::pair<std::int64_t, std::string_view>>{
+            {std::int64_t{1024} * 1024 * 1024, "GB"},
+            {std::int64_t{1024} * 1024, "MB"},
+            {std::int64_t{1024}, "KB"}};
+    for (const auto& [unitSize, unitName] : units)
+        if (size % unitSize == 0)
+            return fmt::format("{} {}", size / unitSize, unitName);
+    return fmt::format("{} bytes", size);
+}
+
+// Resource usage is measured with some inaccuracy, so the usage within 10% of the limit counts as reaching it
+template<typename T>
+bool isNearLimit(const T& usage, const T& limit)
+{
+    return usage * 10 >= limit * 9;
+}
+
+#ifndef _WIN32
+bool setLimit(int resource, std::int64_t softLimit, std::int64_t hardLimit)
+{
+    auto limit = rlimit{};
+    limit.rlim_cur = static_cast<rlim_t>(softLimit);
+    limit.rlim_max = static_cast<rlim_t>(hardLimit);
+    return setrlimit(resource, &limit) == 0;
+}
+#endif
+
+} //namespace
+
+bool readProcessLimit(ProcessLimits& limits, std::string_view limitName, const std::string& value)
+{
+    if (limitName != "memory" && limitName != "CPU time" && limitName != "open files" && limitName != "processes")
+        return false;
+#ifdef _WIN32
+    throw TestConfigError{"Process limits aren't supported on this platform"};
+#else
+    if (limitName == "memory") {
+        const auto size = readDataSize(value);
+        if (!size.has_value() || size.value() <= 0)
+            throw TestConfigError{
+                    fmt::format("Invalid memory limit '{}', value must be specified like '100 MB'", value)};
+        limits.memory = size.value();
+    }
+    else if (limitName == "CPU time") {
+        const auto time = readTime(value);
+        if (!time.has_value() || time.value() <= std::chrono::milliseconds{0})
+            throw TestConfigError{
+                    fmt::format("Invalid CPU time limit '{}', value must be specified like '10 sec'", value)};
+        // The CPU time limit is set in seconds, so the specified time is rounded up
+        limits.cpuTime = std::chrono::ceil<std::chrono::seconds>(time.value());
+    }
+    else if (limitName == "open files")
+        limits.openFiles = readLimitCount(limitName, value);
+    else
+        limits.processes = readLimitCount(limitName, value);
+    return true;
+#endif
+}
+
+bool hasProcessLimits(const ProcessLimits& limits)
+{
+    return limits.memory.has_value() || limits.cpuTime.has_value() || limits.openFiles.has_value() ||
+            limits.processes.has_value();
+}
+
+std::string processLimitsString(const ProcessLimits& limits)
+{
+    auto result = std::vector<std::string>{};
+    if (limits.memory.has_value())
+        result.push_back(fmt::format("memory {}", limitSizeString(limits.memory.value())));
+    if (limits.cpuTime.has_value())
+        result.push_back(fmt::format("CPU time {} s", limits.cpuTime->count()));
+    if (limits.openFiles.has_value())
+        result.push_back(fmt::format("open files {}", limits.openFiles.value()));
+    if (limits.processes.has_value())
+        result.push_back(fmt::format("processes {}", limits.processes.value()));
+    return sfun::join(result, ", ");
+}
+
+bool applyProcessLimits(const ProcessLimits& limits)
+{
+#ifndef _WIN32
+    if (limits.memory.has_value() && !setLimit(RLIMIT_AS, limits.memory.value(), limits.memory.value()))
+        return false;
+    // The soft limit sends SIGXCPU, the hard one set a second later kills the process ignoring it
+    if (limits.cpuTime.has_value() &&
+        !setLimit(RLIMIT_CPU, limits.cpuTime->count(), limits.cpuTime->count() + 1))
+        return false;
+    if (limits.openFiles.has_value() &&
+        !setLimit(RLIMIT_NOFILE, limits.openFiles.value(), limits.openFiles.value()))
+        return false;
+    if (limits.processes.has_value() &&
+        !setLimit(RLIMIT_NPROC, limits.processes.value(), limits.processes.value()))
+        return false;
+#else
+    static_cast<void>(limits);
+#endif
+    return true;
+}
+
+std::optional<std::string> exceededProcessLimit(
+        const ProcessLimits& limits,
+        int terminationSignal,
+        const ProcessResourceUsage& resourceUsage)
+{
+#ifndef _WIN32
+    // SIGXCPU and SIGKILL can be sent by other processes, so they're attributed to the limits
+    // only when the used resources reach them
+    const auto cpuTime = resourceUsage.userCpuTime + resourceUsage.systemCpuTime;
+    if (limits.cpuTime.has_value() && (terminationSignal == SIGXCPU || terminationSignal == SIGKILL) &&
+        isNearLimit(cpuTime, std::chrono::milliseconds{limits.cpuTime.value()}))
+        return fmt::format("CPU time limit {} s exceeded", limits.cpuTime->count());
+    // The memory limit makes allocations fail inside the process, which can end with an abort or a crash
+    // on accessing the unallocated memory. Ordinary crashes end the same way, so the crash is attributed
+    // to the limit only when the resident memory of the process has reached it.
+    const auto isCrash = terminationSignal == SIGABRT || terminationSignal == SIGSEGV || terminationSignal == SIGBUS;
+    if (limits.memory.has_value() && isCrash && isNearLimit(resourceUsage.maxResidentSetSize, limits.memory.value()))
+        return fmt::format("memory limit {} exceeded", limitSizeString(limits.memory.value()));
+#else
+    static_cast<void>(limits);
+    static_cast<void>(terminationSignal);
+    static_cast<void>(resourceUsage);
+#endif
+    return std::nullopt;
+}
+
+} //namespace lunchtoast
@@ -0,0 +1,37 @@
+#pragma once
+#include "launchprocessresult.h"
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace lunchtoast {
+
+// Resource limits set in the launched process before executing its command
+struct ProcessLimits {
+    std::optional<std::int64_t> memory;
+    std::optional<std::chrono::seconds> cpuTime;
+    std::optional<std::int64_t> openFiles;
+    // Set with RLIMIT_NPROC, which counts all processes of the user, not only the launched process tree
+    std::optional<std::int64_t> processes;
+};
+
+// Reads the limit by its name used in the "Limit <name>" sections: "memory", "CPU time", "open files" or "processes".
+// Returns false for an unknown limit name.
+bool readProcessLimit(ProcessLimits& limits, std::string_view limitName, const std::string& value);
+bool hasProcessLimits(const ProcessLimits& limits);
+std::string processLimitsString(const ProcessLimits& limits);
+
+// Called in the child process between fork and exec, so it uses only async-signal-safe functions.
+// Returns false with errno set when one of the limits can't be set.
+bool applyProcessLimits(const ProcessLimits& limits);
+
+// Signals don't tell which limit caused them, so the exceeded limit is guessed
+// from the signal and the used resources of the terminated process
+std::optional<std::string> exceededProcessLimit(
+        const ProcessLimits& limits,
+        int terminationSignal,
+        const ProcessResourceUsage& resourceUsage);
+
+} //namespace lunchtoast
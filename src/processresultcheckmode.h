@@ -1,19 +1,51 @@
 #pragma once
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
 #include <optional>
 #include <string>
 #include <variant>
 
 namespace lunchtoast {
 
+enum class OutputCheckType {
+    Equal,
+    Contains,
+    MatchesLines,
+    LineSetEqual
+};
+
+enum class PerformanceMetric {
+    Duration,
+    MaxMemory
+};
+
 struct ProcessResultCheckMode {
     struct ExitCode {
         std::optional<int> value;
     };
     struct Output {
         std::string value;
+        OutputCheckType type = OutputCheckType::Equal;
+        std::optional<std::string> ignoredLinesPattern = std::nullopt;
     };
     struct ErrorOutput {
         std::string value;
+        OutputCheckType type = OutputCheckType::Equal;
+        std::optional<std::string> ignoredLinesPattern = std::nullopt;
+    };
+    struct MaxMemory {
+        std::int64_t value;
+    };
+    struct MaxDuration {
+        std::chrono::milliseconds value;
+    };
+    struct PerformanceBaseline {
+        PerformanceMetric metric;
+        std::filesystem::path baselineFile;
+        double tolerancePercent;
+        int repetitions;
+        bool updateBaseline;
     };
 
     template<typename T, std::enable_if_t<!std::is_same_v<std::decay_t<T>, ProcessResultCheckMode>>* = nullptr>
@@ -27,7 +59,7 @@ struct ProcessResultCheckMode {
         return value.index() < rhs.value.index();
     }
 
-    std::variant<ExitCode, Output, ErrorOutput> value;
+    std::variant<ExitCode, Output, ErrorOutput, MaxMemory, MaxDuration, PerformanceBaseline> value;
 };
 
 } //namespace lunchtoast
\ No newline at end of file
@@ -0,0 +1,129 @@
+#include "progressdisplay.h"
+#include "constants.h"
+#include <algorithm>
+#include <cstdio>
+#include <utility>
+#ifdef _WIN32
+#include <io.h>
+#include <windows.h>
+#else
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+
+namespace lunchtoast {
+
+namespace {
+int terminalWidth()
+{
+    const auto defaultWidth = 80;
+#ifdef _WIN32
+    auto info = CONSOLE_SCREEN_BUFFER_INFO{};
+    if (!GetConsoleScreenBufferInfo(GetStdHandle(STD_OUTPUT_HANDLE), &info))
+        return defaultWidth;
+    return info.srWindow.Right - info.srWindow.Left + 1;
+#else
+    auto size = winsize{};
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) != 0 || size.ws_col == 0)
+        return defaultWidth;
+    return size.ws_col;
+#endif
+}
+
+} //namespace
+
+ProgressDisplay::~ProgressDisplay()
+{
+    stop();
+}
+
+bool ProgressDisplay::isSupported()
+{
+#ifdef _WIN32
+    return _isatty(_fileno(stdout));
+#else
+    return isatty(STDOUT_FILENO);
+#endif
+}
+
+void ProgressDisplay::start(std::map<std::string, std::optional<std::chrono::milliseconds>> expectedTestDurations)
+{
+    {
+        auto lock = std::scoped_lock{mutex_};
+        status_.emplace(std::move(expectedTestDurations));
+        isStopped_ = false;
+    }
+    updateThread_ = std::thread{&ProgressDisplay::runUpdates, this};
+}
+
+void ProgressDisplay::stop()
+{
+    {
+        auto lock = std::scoped_lock{mutex_};
+        isStopped_ = true;
+        clearStatusLine();
+    }
+    stopCondition_.notify_one();
+    if (updateThread_.joinable())
+        updateThread_.join();
+}
+
+void ProgressDisplay::onTestStarted(const std::string& testName)
+{
+    auto lock = std::scoped_lock{mutex_};
+    if (status_.has_value())
+        status_->onTestStarted(testName, ProgressStatus::Clock::now());
+}
+
+void ProgressDisplay::onTestFinished(const std::string& testName, bool isFailed)
+{
+    auto lock = std::scoped_lock{mutex_};
+    if (status_.has_value())
+        status_->onTestFinished(testName, isFailed, ProgressStatus::Clock::now());
+}
+
+void ProgressDisplay::write(const std::function<void()>& writeOutput)
+{
+    auto lock = std::scoped_lock{mutex_};
+    clearStatusLine();
+    writeOutput();
+}
+
+void ProgressDisplay::runUpdates()
+{
+    // The status line is updated at a fixed rate, rather than on every event
+    auto lock = std::unique_lock{mutex_};
+    const auto isStopped = [this]
+    {
+        return isStopped_;
+    };
+    while (!stopCondition_.wait_for(lock, hardcoded::progressUpdateInterval, isStopped))
+        update();
+}
+
+void ProgressDisplay::update()
+{
+    if (!status_.has_value())
+        return;
+
+    // The line must not be wrapped, otherwise it can't be cleared by returning the carriage
+    auto statusLine = status_->statusLine(ProgressStatus::Clock::now());
+    const auto maxWidth = std::max(terminalWidth() - 1, 0);
+    if (std::ssize(statusLine) > maxWidth)
+        statusLine.resize(static_cast<std::size_t>(maxWidth));
+
+    clearStatusLine();
+    std::fputs(statusLine.c_str(), stdout);
+    std::fflush(stdout);
+    statusLineWidth_ = static_cast<int>(std::ssize(statusLine));
+}
+
+void ProgressDisplay::clearStatusLine()
+{
+    if (statusLineWidth_ == 0)
+        return;
+    std::fprintf(stdout, "\r%*s\r", std::exchange(statusLineWidth_, 0), "");
+    std::fflush(stdout);
+}
+
+} //namespace lunchtoast
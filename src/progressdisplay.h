@@ -0,0 +1,46 @@
+#pragma once
+#include "progressstatus.h"
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace lunchtoast {
+
+// Shows a status line with the testing progress at the bottom of the terminal.
+// Report output must be written with the write() method, so the status line is cleared before it.
+class ProgressDisplay {
+public:
+    ProgressDisplay() = default;
+    ~ProgressDisplay();
+    ProgressDisplay(const ProgressDisplay&) = delete;
+    ProgressDisplay& operator=(const ProgressDisplay&) = delete;
+
+    static bool isSupported();
+
+    void start(std::map<std::string, std::optional<std::chrono::milliseconds>> expectedTestDurations);
+    void stop();
+    void onTestStarted(const std::string& testName);
+    void onTestFinished(const std::string& testName, bool isFailed);
+    void write(const std::function<void()>& writeOutput);
+
+private:
+    void runUpdates();
+    void update();
+    void clearStatusLine();
+
+private:
+    std::mutex mutex_;
+    std::condition_variable stopCondition_;
+    std::optional<ProgressStatus> status_;
+    std::thread updateThread_;
+    int statusLineWidth_ = 0;
+    bool isStopped_ = false;
+};
+
+} //namespace lunchtoast
@@ -0,0 +1,104 @@
+#include "progressstatus.h"
+#include <fmt/format.h>
+#include <algorithm>
+#include <ranges>
+#include <utility>
+
+namespace lunchtoast {
+namespace chrono = std::chrono;
+
+namespace {
+std::string durationString(chrono::milliseconds duration)
+{
+    const auto seconds = chrono::duration_cast<chrono::seconds>(duration).count();
+    if (seconds < 60)
+        return fmt::format("{}s", seconds);
+    if (seconds < 3600)
+        return fmt::format("{}m {}s", seconds / 60, seconds % 60);
+    return fmt::format("{}h {}m", seconds / 3600, seconds % 3600 / 60);
+}
+
+} //namespace
+
+ProgressStatus::ProgressStatus(std::map<std::string, std::optional<chrono::milliseconds>> expectedTestDurations)
+    : pendingTestDurations_{std::move(expectedTestDurations)}
+    , testsCount_{pendingTestDurations_.size()}
+{
+}
+
+void ProgressStatus::onTestStarted(const std::string& testName, Clock::time_point now)
+{
+    auto expectedDuration = std::optional<chrono::milliseconds>{};
+    const auto it = pendingTestDurations_.find(testName);
+    if (it != pendingTestDurations_.end()) {
+        expectedDuration = it->second;
+        pendingTestDurations_.erase(it);
+    }
+    runningTests_.push_back({testName, now, expectedDuration});
+}
+
+void ProgressStatus::onTestFinished(const std::string& testName, bool isFailed, Clock::time_point now)
+{
+    const auto it = std::ranges::find(runningTests_, testName, &RunningTest::name);
+    if (it == runningTests_.end())
+        return;
+
+    finishedTestsDuration_ += chrono::duration_cast<chrono::milliseconds>(now - it->startTime);
+    runningTests_.erase(it);
+    finishedTestsCount_++;
+    if (isFailed)
+        failedTestsCount_++;
+}
+
+std::optional<chrono::milliseconds> ProgressStatus::averageFinishedTestDuration() const
+{
+    if (finishedTestsCount_ == 0)
+        return std::nullopt;
+    return finishedTestsDuration_ / finishedTestsCount_;
+}
+
+std::optional<chrono::milliseconds> ProgressStatus::estimatedTimeLeft(Clock::time_point now) const
+{
+    // Tests without recorded durations are assumed to take an average time of the finished ones
+    const auto averageDuration = averageFinishedTestDuration();
+    const auto estimatedDuration = [&](const std::optional<chrono::milliseconds>& expectedDuration)
+    {
+        return expectedDuration.has_value() ? expectedDuration : averageDuration;
+    };
+
+    auto result = chrono::milliseconds{};
+    for (const auto& expectedDuration : pendingTestDurations_ | std::views::values) {
+        const auto duration = estimatedDuration(expectedDuration);
+        if (!duration.has_value())
+            return std::nullopt;
+        result += duration.value();
+    }
+    for (const auto& runningTest : runningTests_) {
+        const auto duration = estimatedDuration(runningTest.expectedDuration);
+        if (!duration.has_value())
+            return std::nullopt;
+        const auto elapsedTime = chrono::duration_cast<chrono::milliseconds>(now - runningTest.startTime);
+        result += std::max(duration.value() - elapsedTime, chrono::milliseconds{});
+    }
+    return result;
+}
+
+std::string ProgressStatus::statusLine(Clock::time_point now) const
+{
+    auto result = fmt::format("[ {} / {} ]", finishedTestsCount_, testsCount_);
+    if (failedTestsCount_)
+        result += fmt::format(" {} failed", failedTestsCount_);
+
+    for (const auto& runningTest : runningTests_)
+        result += fmt::format(
+                " | {} ({})",
+                runningTest.name,
+                durationString(chrono::duration_cast<chrono::milliseconds>(now - runningTest.startTime)));
+
+    const auto timeLeft = estimatedTimeLeft(now);
+    if (timeLeft.has_value())
+        result += fmt::format(" | ETA: {}", durationString(timeLeft.value()));
+    return result;
+}
+
+} //namespace lunchtoast
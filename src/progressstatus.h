@@ -0,0 +1,39 @@
+#pragma once
+#include <chrono>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace lunchtoast {
+
+class ProgressStatus {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Expected durations are looked up by the test names, as the tests running in parallel can start in any order
+    explicit ProgressStatus(std::map<std::string, std::optional<std::chrono::milliseconds>> expectedTestDurations);
+    void onTestStarted(const std::string& testName, Clock::time_point now);
+    void onTestFinished(const std::string& testName, bool isFailed, Clock::time_point now);
+    std::optional<std::chrono::milliseconds> estimatedTimeLeft(Clock::time_point now) const;
+    std::string statusLine(Clock::time_point now) const;
+
+private:
+    struct RunningTest {
+        std::string name;
+        Clock::time_point startTime;
+        std::optional<std::chrono::milliseconds> expectedDuration;
+    };
+
+    std::optional<std::chrono::milliseconds> averageFinishedTestDuration() const;
+
+private:
+    std::map<std::string, std::optional<std::chrono::milliseconds>> pendingTestDurations_;
+    std::vector<RunningTest> runningTests_;
+    std::size_t testsCount_;
+    int finishedTestsCount_ = 0;
+    int failedTestsCount_ = 0;
+    std::chrono::milliseconds finishedTestsDuration_{};
+};
+
+} //namespace lunchtoast
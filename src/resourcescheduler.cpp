@@ -0,0 +1,110 @@
+#include "resourcescheduler.h"
+#include "errors.h"
+#include "utils.h"
+#include <fmt/format.h>
+#include <sfun/string_utils.h>
+#include <algorithm>
+#include <thread>
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+namespace lunchtoast {
+
+std::map<std::string, std::int64_t> defaultResourceCapacities()
+{
+    auto result = std::map<std::string, std::int64_t>{};
+    result["cpu"] = std::max(std::thread::hardware_concurrency(), 1u);
+#ifdef __linux__
+    const auto pagesCount = sysconf(_SC_PHYS_PAGES);
+    const auto pageSize = sysconf(_SC_PAGESIZE);
+    if (pagesCount > 0 && pageSize > 0)
+        result["mem"] = static_cast<std::int64_t>(pagesCount) * pageSize;
+#endif
+    return result;
+}
+
+ResourceScheduler::ResourceScheduler(std::map<std::string, std::int64_t> capacities)
+    : capacities_{std::move(capacities)}
+{
+}
+
+std::vector<ResourceRequirement> ResourceScheduler::readRequirements(const std::set<std::string>& resources) const
+{
+    auto amounts = std::map<std::string, std::int64_t>{};
+    for (const auto& resource : resources) {
+        const auto resourceName = std::string{sfun::before(resource, ":").value_or(resource)};
+        // Resources without a capacity, like "port:8080", are exclusive and are identified by the whole name
+        if (!capacities_.contains(resourceName)) {
+            amounts[resource] = 1;
+            continue;
+        }
+        const auto amountStr = sfun::after(resource, ":");
+        if (!amountStr.has_value()) {
+            amounts[resourceName] = capacity(resourceName);
+            continue;
+        }
+        const auto amount = readDataSize(amountStr.value());
+        if (!amount.has_value() || amount.value() <= 0)
+            throw TestConfigError{fmt::format("Invalid amount of the resource '{}'", resource)};
+        amounts[resourceName] += amount.value();
+    }
+
+    auto result = std::vector<ResourceRequirement>{};
+    for (const auto& [resourceName, amount] : amounts)
+        result.push_back({resourceName, std::min(amount, capacity(resourceName))});
+    return result;
+}
+
+int ResourceScheduler::addTask(std::vector<ResourceRequirement> requirements)
+{
+    const auto taskIndex = static_cast<int>(std::ssize(tasks_));
+    tasks_.push_back(std::move(requirements));
+    pendingTasks_.push_back(taskIndex);
+    return taskIndex;
+}
+
+std::optional<int> ResourceScheduler::startNextTask()
+{
+    // Resources of the tasks waiting in the queue are reserved for them, so the following tasks are started
+    // only with the remaining free resources. It keeps the waiting tasks from being delayed indefinitely,
+    // as every task fits into the capacities alone and gets its resources after the running tasks finish.
+    auto reservedResources = std::map<std::string, std::int64_t>{};
+    for (auto it = pendingTasks_.begin(); it != pendingTasks_.end(); ++it) {
+        const auto& requirements = tasks_.at(*it);
+        const auto isAvailable = [&](const ResourceRequirement& requirement)
+        {
+            return usedResources_[requirement.name] + reservedResources[requirement.name] + requirement.amount <=
+                    capacity(requirement.name);
+        };
+        if (std::ranges::all_of(requirements, isAvailable)) {
+            for (const auto& requirement : requirements)
+                usedResources_[requirement.name] += requirement.amount;
+            const auto taskIndex = *it;
+            pendingTasks_.erase(it);
+            return taskIndex;
+        }
+        for (const auto& requirement : requirements)
+            reservedResources[requirement.name] += requirement.amount;
+    }
+    return std::nullopt;
+}
+
+void ResourceScheduler::finishTask(int taskIndex)
+{
+    for (const auto& requirement : tasks_.at(taskIndex))
+        usedResources_[requirement.name] -= requirement.amount;
+}
+
+bool ResourceScheduler::hasPendingTasks() const
+{
+    return !pendingTasks_.empty();
+}
+
+std::int64_t ResourceScheduler::capacity(const std::string& resourceName) const
+{
+    const auto it = capacities_.find(resourceName);
+    return it != capacities_.end() ? it->second : 1;
+}
+
+} //namespace lunchtoast
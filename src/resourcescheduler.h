@@ -0,0 +1,46 @@
+#pragma once
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace lunchtoast {
+
+struct ResourceRequirement {
+    std::string name;
+    std::int64_t amount = 1;
+
+    friend bool operator==(const ResourceRequirement&, const ResourceRequirement&) = default;
+};
+
+// Capacities of the counted resources available on this machine: "cpu" as the number of cores and "mem" in bytes
+std::map<std::string, std::int64_t> defaultResourceCapacities();
+
+// Decides which tests can be started without exceeding the capacities of their declared resources.
+// Resources with a capacity are counted, other ones are exclusive and can be used by one test at a time.
+// Tasks acquire all of their resources at once, so they never wait while holding a part of them.
+class ResourceScheduler {
+public:
+    explicit ResourceScheduler(std::map<std::string, std::int64_t> capacities);
+    // Reads resources declared like "port:8080" or "cpu:8", an amount larger than the capacity is reduced to it,
+    // so such tests still can be started when nothing else uses the resource
+    std::vector<ResourceRequirement> readRequirements(const std::set<std::string>& resources) const;
+    // Tasks are started in the order of adding, unless the earlier ones wait for their resources
+    int addTask(std::vector<ResourceRequirement> requirements);
+    std::optional<int> startNextTask();
+    void finishTask(int taskIndex);
+    bool hasPendingTasks() const;
+
+private:
+    std::int64_t capacity(const std::string& resourceName) const;
+
+private:
+    std::map<std::string, std::int64_t> capacities_;
+    std::map<std::string, std::int64_t> usedResources_;
+    std::vector<std::vector<ResourceRequirement>> tasks_;
+    std::vector<int> pendingTasks_;
+};
+
+} //namespace lunchtoast
@@ -0,0 +1,61 @@
+#include "scratchdirectory.h"
+#include "copydirectory.h"
+#include <fmt/format.h>
+#include <sfun/path.h>
+#include <random>
+#include <stdexcept>
+
+namespace lunchtoast {
+namespace fs = std::filesystem;
+
+namespace {
+fs::path createUniqueDirectory(const fs::path& parentDir)
+{
+    auto randomDevice = std::random_device{};
+    auto generator = std::mt19937{randomDevice()};
+    auto distribution = std::uniform_int_distribution<std::uint32_t>{};
+    for (auto attempt = 0; attempt < 100; ++attempt) {
+        const auto dir = parentDir / fmt::format("lunchtoast_{:08x}", distribution(generator));
+        if (fs::create_directory(dir))
+            return dir;
+    }
+    throw std::runtime_error{fmt::format("Can't create a scratch directory in {}\n", sfun::path_string(parentDir))};
+}
+} //namespace
+
+ScratchDirectory::ScratchDirectory(const fs::path& scratchRootDir, const fs::path& testDir)
+    : sourceTestDir_{testDir}
+{
+    fs::create_directories(scratchRootDir);
+    workDir_ = createUniqueDirectory(scratchRootDir);
+    // The test directory name is preserved, as it's used as the default test name and the DIR variable
+    testDir_ = workDir_ / testDir.filename();
+    // Files are copied in the kernel when possible and read-only files are hard linked
+    copyDirectory(testDir, testDir_);
+}
+
+ScratchDirectory::~ScratchDirectory()
+{
+    auto errorCode = std::error_code{};
+    fs::remove_all(workDir_, errorCode);
+}
+
+const fs::path& ScratchDirectory::testDir() const
+{
+    return testDir_;
+}
+
+void ScratchDirectory::copyFailureReports() const
+{
+    // Copying the reports is optional, so its errors don't break the test
+    auto errorCode = std::error_code{};
+    for (const auto& entry : fs::directory_iterator{testDir_, errorCode})
+        if (entry.path().extension() == ".failure_info")
+            fs::copy_file(
+                    entry.path(),
+                    sourceTestDir_ / entry.path().filename(),
+                    fs::copy_options::overwrite_existing,
+                    errorCode);
+}
+
+} //namespace lunchtoast
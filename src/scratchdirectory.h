@@ -0,0 +1,25 @@
+#pragma once
+#include <filesystem>
+
+namespace lunchtoast {
+
+class ScratchDirectory {
+public:
+    ScratchDirectory(const std::filesystem::path& scratchRootDir, const std::filesystem::path& testDir);
+    ~ScratchDirectory();
+    ScratchDirectory(const ScratchDirectory&) = delete;
+    ScratchDirectory& operator=(const ScratchDirectory&) = delete;
+    ScratchDirectory(ScratchDirectory&&) = delete;
+    ScratchDirectory& operator=(ScratchDirectory&&) = delete;
+
+    const std::filesystem::path& testDir() const;
+    // Failure reports are copied to the original test directory, as the scratch directory is removed after the test
+    void copyFailureReports() const;
+
+private:
+    std::filesystem::path sourceTestDir_;
+    std::filesystem::path workDir_;
+    std::filesystem::path testDir_;
+};
+
+} //namespace lunchtoast
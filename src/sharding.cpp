@@ -0,0 +1,34 @@
+#include "sharding.h"
+#include <sfun/contract.h>
+#include <algorithm>
+#include <numeric>
+
+namespace lunchtoast {
+
+std::vector<int> distributeOverShards(const std::vector<std::chrono::milliseconds>& weights, int shardCount)
+{
+    sfun_precondition(shardCount > 0);
+
+    // Greedy longest-processing-time distribution:
+    // the heaviest remaining item goes to the least loaded shard.
+    // Ties are resolved by item and shard indices, so every node of a sharded run computes the same result.
+    auto order = std::vector<std::size_t>(weights.size());
+    std::iota(order.begin(), order.end(), std::size_t{0});
+    std::ranges::stable_sort(
+            order,
+            [&](std::size_t lhs, std::size_t rhs)
+            {
+                return weights[lhs] > weights[rhs];
+            });
+
+    auto shardLoads = std::vector<std::chrono::milliseconds>(static_cast<std::size_t>(shardCount));
+    auto result = std::vector<int>(weights.size());
+    for (auto index : order) {
+        const auto leastLoadedShard = std::ranges::min_element(shardLoads);
+        *leastLoadedShard += weights[index];
+        result[index] = static_cast<int>(std::distance(shardLoads.begin(), leastLoadedShard));
+    }
+    return result;
+}
+
+} //namespace lunchtoast
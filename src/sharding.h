@@ -0,0 +1,9 @@
+#pragma once
+#include <chrono>
+#include <vector>
+
+namespace lunchtoast {
+
+std::vector<int> distributeOverShards(const std::vector<std::chrono::milliseconds>& weights, int shardCount);
+
+} //namespace lunchtoast
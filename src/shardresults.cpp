@@ -0,0 +1,131 @@
+#include "shardresults.h"
+#include "utils.h"
+#include <fmt/format.h>
+#include <range/v3/view.hpp>
+#include <sfun/path.h>
+#include <algorithm>
+#include <fstream>
+#include <optional>
+#include <stdexcept>
+
+namespace lunchtoast {
+namespace views = ranges::views;
+namespace fs = std::filesystem;
+
+namespace {
+void writeSuite(std::ostream& stream, const std::string& suiteName, const TestSuite& suite)
+{
+    stream << "suite\t" << std::ssize(suite.tests) << "\t" << suite.passedTestsCounter << "\t"
+           << suite.disabledTestsCounter << "\t" << suite.skippedTestsCounter << "\t" << suiteName << "\n";
+}
+
+TestSuite& suiteByName(ShardResults& results, const std::string& suiteName)
+{
+    if (suiteName.empty())
+        return results.defaultSuite;
+    return results.suites[suiteName];
+}
+
+} //namespace
+
+void writeShardResults(const ShardResults& results, const fs::path& filePath)
+{
+    auto stream = std::ofstream{filePath};
+    const auto writeSuiteResults = [&](const std::string& suiteName, const TestSuite& suite)
+    {
+        writeSuite(stream, suiteName, suite);
+        const auto it = results.failedTests.find(suiteName);
+        if (it != results.failedTests.end())
+            for (const auto& path : it->second)
+                stream << "failed\t" << sfun::path_string(path) << "\n";
+    };
+    writeSuiteResults("", results.defaultSuite);
+    for (const auto& [suiteName, suite] : results.suites)
+        writeSuiteResults(suiteName, suite);
+
+    for (const auto& [testPath, duration] : results.testDurations)
+        stream << "duration\t" << duration.count() << "\t" << testPath << "\n";
+}
+
+ShardResults readShardResults(const fs::path& filePath)
+{
+    auto stream = std::ifstream{filePath};
+    if (!stream.is_open())
+        throw std::runtime_error{fmt::format("Can't open test results file {}\n", sfun::path_string(filePath))};
+
+    const auto readError = [&](const std::string& line)
+    {
+        return std::runtime_error{
+                fmt::format("Test results file {} contains an invalid line: {}\n", sfun::path_string(filePath), line)};
+    };
+
+    auto result = ShardResults{};
+    auto currentSuiteName = std::optional<std::string>{};
+    auto line = std::string{};
+    while (std::getline(stream, line)) {
+        if (line.empty())
+            continue;
+        const auto fields = readTabSeparatedFields(line);
+        try {
+            if (fields.at(0) == "suite" && fields.size() == 6) {
+                currentSuiteName = fields.at(5);
+                auto& suite = suiteByName(result, currentSuiteName.value());
+                suite.tests.resize(static_cast<std::size_t>(std::stoi(fields.at(1))));
+                suite.passedTestsCounter = std::stoi(fields.at(2));
+                suite.disabledTestsCounter = std::stoi(fields.at(3));
+                suite.skippedTestsCounter = std::stoi(fields.at(4));
+            }
+            else if (fields.at(0) == "failed" && fields.size() == 2 && currentSuiteName.has_value())
+                result.failedTests[currentSuiteName.value()].emplace_back(sfun::make_path(fields.at(1)));
+            else if (fields.at(0) == "duration" && fields.size() == 3)
+                result.testDurations[fields.at(2)] = std::chrono::milliseconds{std::stoll(fields.at(1))};
+            else
+                throw readError(line);
+        }
+        catch (const std::logic_error&) {
+            throw readError(line);
+        }
+    }
+    return result;
+}
+
+void mergeShardResults(ShardResults& results, const ShardResults& shardResults)
+{
+    const auto mergeSuite = [](TestSuite& suite, const TestSuite& shardSuite)
+    {
+        suite.tests.resize(suite.tests.size() + shardSuite.tests.size());
+        suite.passedTestsCounter += shardSuite.passedTestsCounter;
+        suite.disabledTestsCounter += shardSuite.disabledTestsCounter;
+        suite.skippedTestsCounter += shardSuite.skippedTestsCounter;
+    };
+    mergeSuite(results.defaultSuite, shardResults.defaultSuite);
+    for (const auto& [suiteName, suite] : shardResults.suites)
+        mergeSuite(results.suites[suiteName], suite);
+
+    for (const auto& [suiteName, failedTests] : shardResults.failedTests) {
+        auto& mergedFailedTests = results.failedTests[suiteName];
+        mergedFailedTests.insert(mergedFailedTests.end(), failedTests.begin(), failedTests.end());
+        // Tests are collected in the order of their directory paths,
+        // sorting restores the order of a test run without sharding
+        std::ranges::sort(
+                mergedFailedTests,
+                [](const fs::path& lhs, const fs::path& rhs)
+                {
+                    return lhs.parent_path() < rhs.parent_path();
+                });
+    }
+    for (const auto& [testPath, duration] : shardResults.testDurations)
+        results.testDurations.insert_or_assign(testPath, duration);
+}
+
+std::vector<fs::path> failedTestList(const ShardResults& results)
+{
+    // std::map places the default suite with an empty name first,
+    // which matches the order of suites processing in TestLauncher
+    auto result = std::vector<fs::path>{};
+    for (const auto& failedTests : results.failedTests | views::values)
+        result.insert(result.end(), failedTests.begin(), failedTests.end());
+    return result;
+}
+
+} //namespace lunchtoast
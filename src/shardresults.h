@@ -0,0 +1,23 @@
+#pragma once
+#include "testdurations.h"
+#include "testsuite.h"
+#include <filesystem>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace lunchtoast {
+
+struct ShardResults {
+    TestSuite defaultSuite;
+    std::map<std::string, TestSuite> suites;
+    std::map<std::string, std::vector<std::filesystem::path>> failedTests;
+    TestDurations testDurations;
+};
+
+void writeShardResults(const ShardResults& results, const std::filesystem::path& filePath);
+ShardResults readShardResults(const std::filesystem::path& filePath);
+void mergeShardResults(ShardResults& results, const ShardResults& shardResults);
+std::vector<std::filesystem::path> failedTestList(const ShardResults& results);
+
+} //namespace lunchtoast
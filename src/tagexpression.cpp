@@ -0,0 +1,160 @@
+#include "tagexpression.h"
+#include <fmt/format.h>
+#include <sfun/contract.h>
+#include <cctype>
+#include <stdexcept>
+#include <utility>
+
+namespace lunchtoast {
+
+namespace {
+std::vector<std::string> splitExpression(std::string_view expression)
+{
+    auto result = std::vector<std::string>{};
+    auto word = std::string{};
+    const auto addWord = [&]
+    {
+        if (!word.empty())
+            result.push_back(std::exchange(word, {}));
+    };
+    for (auto ch : expression) {
+        if (std::isspace(static_cast<unsigned char>(ch)))
+            addWord();
+        else if (ch == '(' || ch == ')') {
+            addWord();
+            result.emplace_back(1, ch);
+        }
+        else
+            word.push_back(ch);
+    }
+    addWord();
+    return result;
+}
+
+bool isOperator(const std::string& word)
+{
+    return word == "and" || word == "or" || word == "not" || word == "(" || word == ")";
+}
+
+} //namespace
+
+class TagExpression::Parser {
+public:
+    Parser(std::string_view expression, std::vector<Token>& tokens)
+        : expression_{expression}
+        , words_{splitExpression(expression)}
+        , tokens_{tokens}
+    {
+    }
+
+    void parse()
+    {
+        if (words_.empty())
+            fail("expression is empty");
+        parseOr();
+        if (pos_ != std::ssize(words_))
+            fail(fmt::format("unexpected '{}'", words_.at(pos_)));
+    }
+
+private:
+    void parseOr()
+    {
+        parseAnd();
+        while (read("or")) {
+            parseAnd();
+            tokens_.push_back({TokenType::Or, {}});
+        }
+    }
+
+    void parseAnd()
+    {
+        parseNot();
+        while (read("and")) {
+            parseNot();
+            tokens_.push_back({TokenType::And, {}});
+        }
+    }
+
+    void parseNot()
+    {
+        if (read("not")) {
+            parseNot();
+            tokens_.push_back({TokenType::Not, {}});
+            return;
+        }
+        if (read("(")) {
+            parseOr();
+            if (!read(")"))
+                fail("missing ')'");
+            return;
+        }
+        if (pos_ == std::ssize(words_))
+            fail("unexpected end of expression");
+        if (isOperator(words_.at(pos_)))
+            fail(fmt::format("unexpected '{}'", words_.at(pos_)));
+        tokens_.push_back({TokenType::Tag, words_.at(pos_++)});
+    }
+
+    bool read(std::string_view word)
+    {
+        if (pos_ == std::ssize(words_) || words_.at(pos_) != word)
+            return false;
+        pos_++;
+        return true;
+    }
+
+    [[noreturn]] void fail(const std::string& error)
+    {
+        throw std::runtime_error{fmt::format("Invalid tag expression '{}': {}", expression_, error)};
+    }
+
+private:
+    std::string_view expression_;
+    std::vector<std::string> words_;
+    std::vector<Token>& tokens_;
+    int pos_ = 0;
+};
+
+TagExpression::TagExpression(std::string_view expression)
+{
+    auto parser = Parser{expression, tokens_};
+    parser.parse();
+}
+
+bool TagExpression::isSatisfiedBy(const std::set<std::string>& tags) const
+{
+    auto stack = std::vector<bool>{};
+    const auto pop = [&]
+    {
+        sfun_precondition(!stack.empty());
+        const auto value = stack.back();
+        stack.pop_back();
+        return value;
+    };
+    for (const auto& token : tokens_) {
+        switch (token.type) {
+        case TokenType::Tag:
+            stack.push_back(tags.contains(token.tag));
+            break;
+        case TokenType::Not:
+            stack.push_back(!pop());
+            break;
+        case TokenType::And: {
+            const auto rhs = pop();
+            const auto lhs = pop();
+            stack.push_back(lhs && rhs);
+            break;
+        }
+        case TokenType::Or: {
+            const auto rhs = pop();
+            const auto lhs = pop();
+            stack.push_back(lhs || rhs);
+            break;
+        }
+        }
+    }
+    sfun_postcondition(stack.size() == 1);
+    return stack.back();
+}
+
+} //namespace lunchtoast
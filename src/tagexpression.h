@@ -0,0 +1,35 @@
+#pragma once
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace lunchtoast {
+
+// Boolean expression of tag names with operators 'and', 'or', 'not' and parentheses,
+// e.g. "smoke and not (slow or windows)"
+class TagExpression {
+public:
+    explicit TagExpression(std::string_view expression);
+    bool isSatisfiedBy(const std::set<std::string>& tags) const;
+
+private:
+    enum class TokenType {
+        Tag,
+        And,
+        Or,
+        Not
+    };
+    struct Token {
+        TokenType type;
+        std::string tag;
+    };
+
+    class Parser;
+
+private:
+    // Tokens are stored in the reverse Polish notation
+    std::vector<Token> tokens_;
+};
+
+} //namespace lunchtoast
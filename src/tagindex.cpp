@@ -0,0 +1,70 @@
+#include "tagindex.h"
+#include "utils.h"
+#include <sfun/string_utils.h>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace lunchtoast {
+namespace fs = std::filesystem;
+
+TagIndex readTagIndex(const fs::path& filePath)
+{
+    auto result = TagIndex{};
+    if (!fs::exists(filePath))
+        return result;
+
+    auto stream = std::ifstream{filePath};
+    auto line = std::string{};
+    auto linesCount = std::size_t{};
+    auto hasTrailer = false;
+    while (std::getline(stream, line)) {
+        if (line.empty())
+            continue;
+        const auto fields = readTabSeparatedFields(line);
+        try {
+            if (hasTrailer)
+                throw std::invalid_argument{line};
+            if (fields.size() == 2 && fields.at(0) == "end") {
+                if (std::stoull(fields.at(1)) != linesCount)
+                    throw std::invalid_argument{line};
+                hasTrailer = true;
+                continue;
+            }
+            linesCount++;
+            if (fields.size() != 4)
+                throw std::invalid_argument{line};
+            result[fields.at(2)] = TagIndexEntry{
+                    .modificationTime = std::stoll(fields.at(0)),
+                    .fileSize = std::stoull(fields.at(1)),
+                    .tags = fields.at(3)};
+        }
+        // The index is only a cache of the test tags, so a malformed or truncated one is rebuilt from scratch
+        catch (const std::logic_error&) {
+            return {};
+        }
+    }
+    if (!hasTrailer)
+        return {};
+    return result;
+}
+
+void writeTagIndex(const TagIndex& index, const fs::path& filePath)
+{
+    writeFileAtomically(
+            filePath,
+            [&](std::ostream& stream)
+            {
+                for (const auto& [testPath, entry] : index) {
+                    // Tags are separated by whitespace, so line breaks in multiline sections can be replaced
+                    const auto tags = sfun::replace(sfun::replace(entry.tags, "\n", " "), "\t", " ");
+                    stream << entry.modificationTime << "\t" << entry.fileSize << "\t" << testPath << "\t" << tags
+                           << "\n";
+                }
+                // The trailer with the number of entries lets the reader detect a truncated index
+                stream << "end\t" << index.size() << "\n";
+            });
+}
+
+} //namespace lunchtoast
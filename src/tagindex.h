@@ -0,0 +1,22 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <string>
+
+namespace lunchtoast {
+
+struct TagIndexEntry {
+    std::int64_t modificationTime = 0;
+    std::uintmax_t fileSize = 0;
+    std::string tags;
+};
+
+// Values of the 'Tags' sections of test case files, stored by their paths.
+// An entry is valid while the modification time and the size of its file are unchanged.
+using TagIndex = std::map<std::string, TagIndexEntry>;
+
+TagIndex readTagIndex(const std::filesystem::path& filePath);
+void writeTagIndex(const TagIndex& index, const std::filesystem::path& filePath);
+
+} //namespace lunchtoast
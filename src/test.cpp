@@ -3,6 +3,7 @@
 #include "comparefiles.h"
 #include "constants.h"
 #include "errors.h"
+#include "generatefile.h"
 #include "launchprocess.h"
 #include "sectionsreader.h"
 #include "utils.h"
@@ -18,6 +19,7 @@
 #include <algorithm>
 #include <fstream>
 #include <functional>
+#include <regex>
 #include <sstream>
 
 namespace lunchtoast {
@@ -52,12 +54,20 @@ std::vector<FilenameGroup> getDefaultContents(const fs::path& testDirectory)
 Test::Test(
         const fs::path& testCasePath,
         const std::unordered_map<std::string, std::string>& vars,
-        std::vector<UserAction> userActions,
+        const UserActionList& userActions,
+        PortAllocator& portAllocator,
+        fs::path dataCacheDir,
         std::string shellCommand,
-        bool cleanup)
-    : userActions_{std::move(userActions)}
+        bool cleanup,
+        bool updateBaselines,
+        sfun::optional_ref<TestCancellation> cancellation)
+    : userActions_{userActions}
+    , portAllocator_{portAllocator}
+    , dataCacheDir_{std::move(dataCacheDir)}
     , shellCommand_(std::move(shellCommand))
     , cleanup_(cleanup)
+    , updateBaselines_(updateBaselines)
+    , cancellation_{cancellation}
     , directory_(testCasePath.parent_path())
     , name_(sfun::path_string(directory_.filename()))
     , isEnabled_(true)
@@ -96,20 +106,28 @@ TestResult Test::process()
     const auto closeDetachedProcesses = gsl::finally(
             [&]
             {
-                for (auto& detachedProcess : detachedProcessList_)
-                    while (detachedProcess.running()) {
-#ifndef _WIN32
-                        auto errorCode = std::error_code{};
-                        detachedProcess.terminate(errorCode);
-#else
-                        const auto id = detachedProcess.id();
-                        detachedProcess.detach();
-                        runCommand(std::format("taskkill /f /t /pid {}", id));
-#endif
-                    }
+                terminateDetachedProcesses(detachedProcessList_);
             });
 
+    const auto isCancelled = [&]
+    {
+        return cancellation_.get().has_value() && cancellation_.get()->isCancelled();
+    };
+    const auto stopTesting = [&](bool hasFailedBefore)
+    {
+        // The test that failed before the testing was stopped isn't considered interrupted, its failure is reported
+        isInterrupted_ = !hasFailedBefore;
+        testResult = false;
+        return TestResult::RuntimeError("Testing was stopped", failedActionsMessages);
+    };
+
+    isInterrupted_ = false;
     for (auto& action : actions_) {
+        // Remaining actions aren't launched after the testing is stopped, the test files are kept as they are
+        const auto hasFailedBefore = !testResult;
+        if (isCancelled())
+            return stopTesting(hasFailedBefore);
+
         auto actionResult = true;
         const auto onActionFailed = [&](auto&, const std::string& errorInfo)
         {
@@ -120,6 +138,10 @@ TestResult Test::process()
 
         action.process(onActionSuccessful, onActionFailed, onActionError);
 
+        // The action failed after the testing was stopped is interrupted, as its processes could be killed
+        if ((!actionResult || runtimeError) && isCancelled())
+            return stopTesting(hasFailedBefore);
+
         if (runtimeError)
             return TestResult::RuntimeError(runtimeError.value(), failedActionsMessages);
 
@@ -133,6 +155,37 @@ TestResult Test::process()
     return testResult ? TestResult::Success() : TestResult::Failure(failedActionsMessages);
 }
 
+TestResult Test::processIteration(int iteration)
+{
+    auto result = process();
+    if (result.type() == TestResultType::Success)
+        return result;
+
+    // Failure reports of each failed iteration are renamed, so they aren't overwritten
+    // or removed by the cleanup of the following iterations
+    auto failedActionsMessages = result.failedActionsMessages();
+    auto failureReports = std::vector<fs::path>{};
+    for (const auto& entry : fs::directory_iterator{directory_})
+        if (entry.path().extension() == ".failure_info" && !keptFailureReports_.contains(entry.path()))
+            failureReports.push_back(entry.path());
+
+    for (const auto& failureReport : failureReports) {
+        const auto iterationFailureReport = directory_ /
+                fmt::format("{}.iteration_{}.failure_info", sfun::path_string(failureReport.stem()), iteration);
+        fs::rename(failureReport, iterationFailureReport);
+        keptFailureReports_.insert(iterationFailureReport);
+        for (auto& message : failedActionsMessages)
+            message = sfun::replace(
+                    message,
+                    sfun::path_string(failureReport.filename()),
+                    sfun::path_string(iterationFailureReport.filename()));
+    }
+
+    if (result.type() == TestResultType::RuntimeError)
+        return TestResult::RuntimeError(result.errorInfo(), failedActionsMessages);
+    return TestResult::Failure(failedActionsMessages);
+}
+
 std::vector<Section> Test::readParam(const std::vector<Section>& sections)
 {
     if (sections.empty())
@@ -157,14 +210,14 @@ std::vector<Section> Test::readParam(const std::vector<Section>& sections)
 }
 
 namespace {
-template<typename TAction>
+template<typename... TAction>
 int countActions(const std::vector<TestAction>& actions)
 {
     return gsl::narrow_cast<int>(std::ranges::count_if(
             actions,
             [](const auto& action)
             {
-                return action.template is<TAction>();
+                return (action.template is<TAction>() || ...);
             }));
 }
 } //namespace
@@ -177,7 +230,7 @@ std::vector<Section> Test::readAction(
         return sections;
 
     const auto& section = sections.front();
-    for (const auto& userAction : userActions_.get()) {
+    for (const UserAction& userAction : userActions_.get().matchingCandidates(section.name)) {
         auto command = userAction.makeCommand(section.name, vars, section.value);
         if (command.has_value()) {
             actions_.push_back(
@@ -186,12 +239,20 @@ std::vector<Section> Test::readAction(
                              directory_,
                              shellCommand_,
                              userAction.makeProcessResultCheckModeSet(vars, section.value),
-                             countActions<LaunchProcess>(actions_)},
+                             countActions<LaunchProcess, LaunchPipeline>(actions_),
+                             std::nullopt,
+                             false,
+                             userAction.makeProcessLimits(vars),
+                             {},
+                             cancellation_},
                      userAction.actionType()});
             return sections | views::drop(1) | ranges::to<std::vector>;
         }
     }
 
+    if (section.name.starts_with("Launch pipeline")) {
+        return createLaunchPipelineAction(section, sections | views::drop(1) | ranges::to<std::vector>);
+    }
     if (section.name.starts_with("Launch")) {
         return createLaunchAction(section, sections | views::drop(1) | ranges::to<std::vector>);
     }
@@ -199,8 +260,12 @@ std::vector<Section> Test::readAction(
         createWriteAction(section);
         return sections | views::drop(1) | ranges::to<std::vector>;
     }
+    if (section.name.starts_with("Generate")) {
+        createGenerateAction(section);
+        return sections | views::drop(1) | ranges::to<std::vector>;
+    }
     if (section.name.starts_with("Wait")) {
-        actions_.emplace_back(makeWaitAction(section), TestActionType::RequiredOperation);
+        actions_.emplace_back(makeWaitAction(section, cancellation_), TestActionType::RequiredOperation);
         return sections | views::drop(1) | ranges::to<std::vector>;
     }
     if (section.name.starts_with("Assert")) {
@@ -227,6 +292,8 @@ std::vector<Section> readValidUnusedSection(const std::vector<Section>& sections
         return sections | views::drop(1) | ranges::to<std::vector>;
     if (section.name == "Tags")
         return sections | views::drop(1) | ranges::to<std::vector>;
+    if (section.name == "Resources")
+        return sections | views::drop(1) | ranges::to<std::vector>;
 
     return sections;
 }
@@ -240,9 +307,10 @@ void Test::readTestCase(const fs::path& path, const std::unordered_map<std::stri
 
     try {
         auto sections = readSections(fileStream);
+        const auto testVars = addPortVariables(vars, sections);
         const auto setSectionVars = [&](Section& section)
         {
-            section.value = processVariablesSubstitution(section.value, vars);
+            section.value = processVariablesSubstitution(section.value, testVars);
             return section;
         };
         sections = sections | views::transform(setSectionVars) | ranges::to<std::vector>;
@@ -254,7 +322,7 @@ void Test::readTestCase(const fs::path& path, const std::unordered_map<std::stri
         while (std::ssize(sections) != sectionsCount) {
             sectionsCount = std::ssize(sections);
             sections = readParam(sections);
-            sections = readAction(sections, vars);
+            sections = readAction(sections, testVars);
             sections = readValidUnusedSection(sections);
         }
         if (!sections.empty())
@@ -267,6 +335,29 @@ void Test::readTestCase(const fs::path& path, const std::unordered_map<std::stri
     checkParams();
 }
 
+std::unordered_map<std::string, std::string> Test::addPortVariables(
+        const std::unordered_map<std::string, std::string>& vars,
+        const std::vector<Section>& sections)
+{
+    auto portsCount = 0;
+    for (const auto& section : sections)
+        portsCount = std::max(portsCount, maxPortVariableIndex(section.value));
+    for (const auto& [name, value] : vars)
+        portsCount = std::max(portsCount, maxPortVariableIndex(value));
+    if (!portsCount)
+        return vars;
+
+    allocatedPorts_.emplace(portAllocator_, portsCount);
+    auto portVars = std::unordered_map<std::string, std::string>{};
+    for (auto i = 0; i < portsCount; ++i)
+        portVars[fmt::format("PORT_{}", i + 1)] = std::to_string(allocatedPorts_->ports().at(i));
+
+    auto result = portVars;
+    for (const auto& [name, value] : vars)
+        result.emplace(name, processVariablesSubstitution(value, portVars));
+    return result;
+}
+
 void Test::checkParams()
 {
     if (!fs::exists(directory_))
@@ -285,7 +376,129 @@ void Test::createComparisonAction(
         createCompareFileContentAction(actionType, encodedActionType, section.value);
 }
 namespace {
-std::tuple<std::set<ProcessResultCheckMode>, TestActionType> getResultCheckMode(const std::vector<Section>& sections)
+struct OutputCheckSection {
+    TestActionType actionType;
+    bool isErrorOutput;
+    OutputCheckType checkType;
+};
+
+std::optional<OutputCheckSection> readOutputCheckSectionName(std::string_view sectionName)
+{
+    const auto actionTypes = std::vector<std::pair<std::string_view, TestActionType>>{
+            {"Assert ", TestActionType::Assertion},
+            {"Expect ", TestActionType::Expectation}};
+    const auto checkTypes = std::vector<std::pair<std::string_view, OutputCheckType>>{
+            {"", OutputCheckType::Equal},
+            {" contains", OutputCheckType::Contains},
+            {" matches", OutputCheckType::MatchesLines},
+            {" line set", OutputCheckType::LineSetEqual}};
+
+    for (const auto& [actionPrefix, actionType] : actionTypes) {
+        if (!sectionName.starts_with(actionPrefix))
+            continue;
+        auto checkName = sectionName.substr(actionPrefix.size());
+        const auto isErrorOutput = checkName.starts_with("error output");
+        if (!isErrorOutput && !checkName.starts_with("output"))
+            return std::nullopt;
+        checkName.remove_prefix(isErrorOutput ? "error output"sv.size() : "output"sv.size());
+        for (const auto& [checkSuffix, checkType] : checkTypes)
+            if (checkName == checkSuffix)
+                return OutputCheckSection{actionType, isErrorOutput, checkType};
+    }
+    return std::nullopt;
+}
+
+void validateRegex(const std::string& pattern)
+{
+    try {
+        [[maybe_unused]] auto regex = std::regex{pattern};
+    }
+    catch (const std::regex_error& e) {
+        throw TestConfigError{fmt::format("Invalid regular expression '{}': {}", pattern, e.what())};
+    }
+}
+
+template<typename TOutputCheckMode>
+void setIgnoredLinesPattern(
+        std::vector<ProcessResultCheckMode>& checkModes,
+        const std::optional<std::string>& pattern,
+        std::string_view sectionName)
+{
+    if (!pattern.has_value())
+        return;
+    for (auto& checkMode : checkModes)
+        if (auto outputCheckMode = std::get_if<TOutputCheckMode>(&checkMode.value)) {
+            outputCheckMode->ignoredLinesPattern = pattern;
+            return;
+        }
+    throw TestConfigError{
+            fmt::format("Section '{}' must be used together with the corresponding output check", sectionName)};
+}
+
+struct PerformanceBaselineSection {
+    TestActionType actionType;
+    PerformanceMetric metric;
+    std::string baselineFileName;
+};
+
+std::optional<PerformanceBaselineSection> readPerformanceBaselineSectionName(std::string_view sectionName)
+{
+    static const auto format = std::regex{R"((Assert|Expect) (duration|memory) baseline (.+))"};
+    auto match = std::cmatch{};
+    if (!std::regex_match(sectionName.data(), sectionName.data() + sectionName.size(), match, format))
+        return std::nullopt;
+    return PerformanceBaselineSection{
+            .actionType = match[1] == "Assert" ? TestActionType::Assertion : TestActionType::Expectation,
+            .metric = match[2] == "duration" ? PerformanceMetric::Duration : PerformanceMetric::MaxMemory,
+            .baselineFileName = std::string{sfun::trim(match[3].str())}};
+}
+
+ProcessResultCheckMode::PerformanceBaseline makePerformanceBaselineCheck(
+        const PerformanceBaselineSection& section,
+        const std::string& value,
+        const fs::path& directory,
+        bool updateBaseline)
+{
+    static const auto format = std::regex{R"((\d+(?:\.\d+)?)\s*%(?:\s+over\s+(\d+)\s+repetitions?)?)"};
+    auto match = std::smatch{};
+    const auto valueStr = std::string{sfun::trim(value)};
+    if (!std::regex_match(valueStr, match, format))
+        throw TestConfigError{fmt::format(
+                "Invalid performance baseline check '{}', value must be specified like '15%' or '15% over 5 "
+                "repetitions'",
+                value)};
+
+    auto repetitions = 5;
+    try {
+        if (match[2].matched)
+            repetitions = std::stoi(match[2].str());
+    }
+    catch (const std::out_of_range&) {
+        throw TestConfigError{fmt::format("Invalid performance baseline check '{}', too many repetitions", value)};
+    }
+    if (repetitions <= 0)
+        throw TestConfigError{"Performance baseline check must use a positive number of repetitions"};
+
+    return {.metric = section.metric,
+            .baselineFile = fs::absolute(directory) / sfun::make_path(section.baselineFileName),
+            .tolerancePercent = std::stod(match[1].str()),
+            .repetitions = repetitions,
+            .updateBaseline = updateBaseline};
+}
+
+struct ResultCheckModeReadResult {
+    std::set<ProcessResultCheckMode> checkModeSet;
+    TestActionType actionType;
+    ProcessLimits limits;
+    ProcessInput input;
+    std::vector<ProcessResultCheckMode::ExitCode> stageExitCodes;
+    int sectionsCount;
+};
+
+ResultCheckModeReadResult getResultCheckMode(
+        const std::vector<Section>& sections,
+        const fs::path& directory,
+        bool updateBaselines)
 {
     auto makeExitCodeCheck = [](const std::string& str)
     {
@@ -299,6 +512,22 @@ std::tuple<std::set<ProcessResultCheckMode>, TestActionType> getResultCheckMode(
         }
     };
 
+    auto makeMaxMemoryCheck = [](const std::string& str)
+    {
+        const auto size = readDataSize(str);
+        if (!size.has_value())
+            throw TestConfigError{fmt::format("Invalid memory size '{}', value must be specified like '100 MB'", str)};
+        return ProcessResultCheckMode::MaxMemory{size.value()};
+    };
+
+    auto makeMaxDurationCheck = [](const std::string& str)
+    {
+        const auto time = readTime(str);
+        if (!time.has_value())
+            throw TestConfigError{fmt::format("Invalid duration '{}', value must be specified like '500 ms'", str)};
+        return ProcessResultCheckMode::MaxDuration{time.value()};
+    };
+
     auto actionType = std::optional<TestActionType>();
     auto updateActionType = [&](TestActionType newActionType)
     {
@@ -310,6 +539,12 @@ std::tuple<std::set<ProcessResultCheckMode>, TestActionType> getResultCheckMode(
         }
     };
     auto checkModes = std::vector<ProcessResultCheckMode>{};
+    auto ignoredOutputLinesPattern = std::optional<std::string>{};
+    auto ignoredErrorOutputLinesPattern = std::optional<std::string>{};
+    auto limits = ProcessLimits{};
+    auto input = ProcessInput{};
+    auto stageExitCodes = std::optional<std::vector<ProcessResultCheckMode::ExitCode>>{};
+    auto sectionsCount = 0;
     for (const auto& section : sections) {
         if (section.name == "Assert exit code") {
             checkModes.emplace_back(makeExitCodeCheck(section.value));
@@ -319,35 +554,118 @@ std::tuple<std::set<ProcessResultCheckMode>, TestActionType> getResultCheckMode(
             checkModes.emplace_back(makeExitCodeCheck(section.value));
             updateActionType(TestActionType::Expectation);
         }
-        else if (section.name == "Assert output") {
-            checkModes.emplace_back(ProcessResultCheckMode::Output{section.value});
-            updateActionType(TestActionType::Assertion);
+        else if (section.name == "Assert exit codes" || section.name == "Expect exit codes") {
+            if (stageExitCodes.has_value())
+                throw TestConfigError{"Launched pipeline action can't have multiple exit codes checks"};
+            stageExitCodes = splitSectionValue(section.value) | views::transform(makeExitCodeCheck) |
+                    ranges::to<std::vector>;
+            updateActionType(
+                    section.name.starts_with("Assert") ? TestActionType::Assertion : TestActionType::Expectation);
         }
-        else if (section.name == "Expect output") {
-            checkModes.emplace_back(ProcessResultCheckMode::Output{section.value});
-            updateActionType(TestActionType::Expectation);
+        else if (section.name == "Assert max memory" || section.name == "Expect max memory") {
+            checkModes.emplace_back(makeMaxMemoryCheck(section.value));
+            updateActionType(
+                    section.name.starts_with("Assert") ? TestActionType::Assertion : TestActionType::Expectation);
         }
-        else if (section.name == "Assert error output") {
-            checkModes.emplace_back(ProcessResultCheckMode::ErrorOutput{section.value});
-            updateActionType(TestActionType::Assertion);
+        else if (section.name == "Assert duration below" || section.name == "Expect duration below") {
+            checkModes.emplace_back(makeMaxDurationCheck(section.value));
+            updateActionType(
+                    section.name.starts_with("Assert") ? TestActionType::Assertion : TestActionType::Expectation);
         }
-        else if (section.name == "Expect error output") {
-            checkModes.emplace_back(ProcessResultCheckMode::ErrorOutput{section.value});
-            updateActionType(TestActionType::Expectation);
+        else if (const auto baselineCheck = readPerformanceBaselineSectionName(section.name)) {
+            checkModes.emplace_back(
+                    makePerformanceBaselineCheck(baselineCheck.value(), section.value, directory, updateBaselines));
+            updateActionType(baselineCheck->actionType);
+        }
+        else if (const auto outputCheck = readOutputCheckSectionName(section.name)) {
+            if (outputCheck->checkType == OutputCheckType::MatchesLines) {
+                const auto patterns = normalizeLineEndings(section.value);
+                for (const auto& pattern : sfun::split(patterns, "\n"))
+                    validateRegex(std::string{pattern});
+            }
+            if (outputCheck->isErrorOutput)
+                checkModes.emplace_back(ProcessResultCheckMode::ErrorOutput{section.value, outputCheck->checkType});
+            else
+                checkModes.emplace_back(ProcessResultCheckMode::Output{section.value, outputCheck->checkType});
+            updateActionType(outputCheck->actionType);
+        }
+        else if (section.name == "Ignore output lines matching") {
+            validateRegex(section.value);
+            ignoredOutputLinesPattern = section.value;
+        }
+        else if (section.name == "Ignore error output lines matching") {
+            validateRegex(section.value);
+            ignoredErrorOutputLinesPattern = section.value;
+        }
+        else if (section.name == "Input") {
+            input.text = section.value;
+        }
+        else if (section.name == "Input file") {
+            input.file = fs::absolute(directory) / sfun::make_path(std::string{sfun::trim(section.value)});
+        }
+        else if (section.name.starts_with("Limit ")) {
+            if (!readProcessLimit(limits, std::string_view{section.name}.substr("Limit "sv.size()), section.value))
+                break;
         }
         else
             break;
+        ++sectionsCount;
     }
-    if (std::ssize(checkModes) > 3)
-        throw TestConfigError{
-                "Launched process action supports maximum 3 result checks (exit code, output and error output)"};
+    setIgnoredLinesPattern<ProcessResultCheckMode::Output>(
+            checkModes,
+            ignoredOutputLinesPattern,
+            "Ignore output lines matching");
+    setIgnoredLinesPattern<ProcessResultCheckMode::ErrorOutput>(
+            checkModes,
+            ignoredErrorOutputLinesPattern,
+            "Ignore error output lines matching");
+
+    if (input.text.has_value() && input.file.has_value())
+        throw TestConfigError{"Launched process can't use both Input and Input file sections"};
 
     auto result = std::set<ProcessResultCheckMode>{checkModes.begin(), checkModes.end()};
     if (std::ssize(checkModes) != std::ssize(result))
         throw TestConfigError{
-                "Launched process action result checks type must be unique (exit code, output and error output)"};
+                "Launched process action result checks type must be unique "
+                "(exit code, output, error output, max memory, duration and performance baseline)"};
+
+    return {.checkModeSet = result,
+            .actionType = actionType.has_value() ? actionType.value() : TestActionType::Assertion,
+            .limits = limits,
+            .input = std::move(input),
+            .stageExitCodes = stageExitCodes.value_or(std::vector<ProcessResultCheckMode::ExitCode>{}),
+            .sectionsCount = sectionsCount};
+}
+
+} //namespace
+
+namespace {
+template<typename TCheckMode>
+bool hasCheckMode(const std::set<ProcessResultCheckMode>& checkModeSet)
+{
+    return std::ranges::any_of(
+            checkModeSet,
+            [](const ProcessResultCheckMode& checkMode)
+            {
+                return std::holds_alternative<TCheckMode>(checkMode.value);
+            });
+}
+
+std::optional<fs::path> findLaunchedExecutable(const std::string& command, const fs::path& workingDir)
+{
+    const auto commandParts = splitCommand(command);
+    if (commandParts.empty())
+        return std::nullopt;
+    // Commands found in PATH are skipped, only the executables specified by their paths are tracked
+    const auto path = sfun::make_path(commandParts.front());
+    if (!path.has_parent_path())
+        return std::nullopt;
 
-    return {result, actionType.has_value() ? actionType.value() : TestActionType::Assertion};
+    auto errorCode = std::error_code{};
+    const auto executablePath = fs::weakly_canonical(workingDir / path, errorCode);
+    if (errorCode || !fs::is_regular_file(executablePath, errorCode))
+        return std::nullopt;
+    return executablePath;
 }
 
 } //namespace
@@ -365,29 +683,74 @@ std::vector<Section> Test::createLaunchAction(const Section& section, const std:
     const auto skipReadingOutput = //
             contains(parts, {"ignore"sv, "output"sv}) || contains(parts, {"ignoring"sv, "output"sv});
 
-    const auto [checkModeSet, actionType, foundCheckModesCount] = [&]
+    const auto [checkModeSet, actionType, limits, input, foundCheckSectionsCount] = [&]
     {
-        const auto [checkModeSetRes, actionTypeRes] = getResultCheckMode(nextSections);
+        const auto [checkModeSetRes, actionTypeRes, limitsRes, inputRes, stageExitCodesRes, sectionsCountRes] =
+                getResultCheckMode(nextSections, directory_, updateBaselines_);
+        if (!stageExitCodesRes.empty())
+            throw TestConfigError{
+                    "Exit codes of the pipeline stages can only be checked after the Launch pipeline action"};
         if (checkModeSetRes.empty())
             return std::make_tuple(
                     views::single(ProcessResultCheckMode::ExitCode{0}) | ranges::to<std::set<ProcessResultCheckMode>>,
                     TestActionType::Assertion,
-                    std::ssize(checkModeSetRes));
-        return std::make_tuple(checkModeSetRes, actionTypeRes, std::ssize(checkModeSetRes));
+                    limitsRes,
+                    inputRes,
+                    sectionsCountRes);
+        return std::make_tuple(checkModeSetRes, actionTypeRes, limitsRes, inputRes, sectionsCountRes);
     }();
 
+    const auto command = std::string{sfun::trim(section.value)};
+    const auto executable = findLaunchedExecutable(command, directory_);
+    if (executable.has_value())
+        launchedExecutables_.push_back(executable.value());
+
     actions_.push_back(
             {LaunchProcess{
-                     std::string{sfun::trim(section.value)},
+                     command,
                      directory_,
                      shellCommand(),
                      checkModeSet,
-                     countActions<LaunchProcess>(actions_),
+                     countActions<LaunchProcess, LaunchPipeline>(actions_),
                      isDetached ? &detachedProcessList_ : nullptr,
-                     skipReadingOutput},
+                     skipReadingOutput,
+                     limits,
+                     input,
+                     cancellation_},
+             actionType});
+
+    return nextSections | views::drop(foundCheckSectionsCount) | ranges::to<std::vector>;
+}
+
+std::vector<Section> Test::createLaunchPipelineAction(const Section& section, const std::vector<Section>& nextSections)
+{
+    const auto [checkModeSet, actionType, limits, input, stageExitCodes, foundCheckSectionsCount] =
+            getResultCheckMode(nextSections, directory_, updateBaselines_);
+    if (hasCheckMode<ProcessResultCheckMode::ExitCode>(checkModeSet))
+        throw TestConfigError{"Exit codes of the Launch pipeline action must be checked with the exit codes section"};
+    if (hasCheckMode<ProcessResultCheckMode::PerformanceBaseline>(checkModeSet))
+        throw TestConfigError{"Performance baseline checks can't be used with the Launch pipeline action"};
+
+    const auto command = std::string{sfun::trim(section.value)};
+    for (const auto& stageCommand : splitPipeline(command)) {
+        const auto executable = findLaunchedExecutable(stageCommand, directory_);
+        if (executable.has_value())
+            launchedExecutables_.push_back(executable.value());
+    }
+
+    actions_.push_back(
+            {LaunchPipeline{
+                     command,
+                     directory_,
+                     checkModeSet,
+                     stageExitCodes,
+                     countActions<LaunchProcess, LaunchPipeline>(actions_),
+                     limits,
+                     input,
+                     cancellation_},
              actionType});
 
-    return nextSections | views::drop(foundCheckModesCount) | ranges::to<std::vector>;
+    return nextSections | views::drop(foundCheckSectionsCount) | ranges::to<std::vector>;
 }
 
 void Test::createWriteAction(const Section& section)
@@ -399,6 +762,17 @@ void Test::createWriteAction(const Section& section)
     actions_.push_back({WriteFile{path, section.value}, TestActionType::RequiredOperation});
 }
 
+void Test::createGenerateAction(const Section& section)
+{
+    sfun_precondition(section.name.starts_with("Generate"));
+
+    const auto fileName = sfun::trim(sfun::after(section.name, "Generate").value());
+    const auto path = fs::absolute(directory_) / sfun::make_path(fileName);
+    actions_.push_back(
+            {GenerateFile{path, readGeneratedDataSpec(section.value), dataCacheDir_},
+             TestActionType::RequiredOperation});
+}
+
 void Test::createCompareFilesAction(
         TestActionType actionType,
         const std::string& comparisonType,
@@ -435,7 +809,7 @@ void Test::cleanTestFiles()
 
     const auto notInContentPaths = [&](const fs::path& path)
     {
-        return !contentsPaths.count(path);
+        return !contentsPaths.count(path) && !keptFailureReports_.count(path);
     };
     const auto paths = getDirectoryContent(directory_) | ranges::actions::sort(std::greater<>{});
     const auto pathsNotInContent = paths | views::filter(notInContentPaths) | ranges::to<std::vector>;
@@ -447,6 +821,11 @@ void Test::cleanTestFiles()
             });
 }
 
+bool Test::wasInterrupted() const
+{
+    return isInterrupted_;
+}
+
 const std::string& Test::suite() const
 {
     return suite_;
@@ -462,6 +841,11 @@ const std::string& Test::description() const
     return description_;
 }
 
+const std::vector<fs::path>& Test::launchedExecutables() const
+{
+    return launchedExecutables_;
+}
+
 bool Test::readParam(std::string& param, const std::string& paramName, const Section& section)
 {
     if (section.name != paramName)
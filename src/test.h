@@ -1,11 +1,14 @@
 #pragma once
 #include "filenamegroup.h"
 #include "launchprocessresult.h"
+#include "portallocator.h"
 #include "section.h"
+#include "testcancellation.h"
 #include "testaction.h"
 #include "testresult.h"
-#include "useraction.h"
+#include "useractionlist.h"
 #include <sfun/member.h>
+#include <sfun/optional_ref.h>
 #include <boost/process/child.hpp>
 #include <filesystem>
 #include <memory>
@@ -21,23 +24,36 @@ public:
     explicit Test(
             const std::filesystem::path& testCasePath,
             const std::unordered_map<std::string, std::string>& vars,
-            std::vector<UserAction> userActions,
+            const UserActionList& userActions,
+            PortAllocator& portAllocator,
+            std::filesystem::path dataCacheDir,
             std::string shellCommand,
-            bool cleanup);
+            bool cleanup,
+            bool updateBaselines,
+            sfun::optional_ref<TestCancellation> cancellation);
     TestResult process();
+    TestResult processIteration(int iteration);
+    // Returns true if the last processing of the test was interrupted by the cancellation of the testing
+    bool wasInterrupted() const;
 
     const std::string& suite() const;
     const std::string& name() const;
     const std::string& description() const;
+    const std::vector<std::filesystem::path>& launchedExecutables() const;
 
 private:
     void readTestCase(const std::filesystem::path& path, const std::unordered_map<std::string, std::string>& vars);
+    std::unordered_map<std::string, std::string> addPortVariables(
+            const std::unordered_map<std::string, std::string>& vars,
+            const std::vector<Section>& sections);
     std::vector<Section> readParam(const std::vector<Section>& sections);
     std::vector<Section> readAction(
             const std::vector<Section>& sections,
             const std::unordered_map<std::string, std::string>& vars);
     std::vector<Section> createLaunchAction(const Section& section, const std::vector<Section>& nextSections);
+    std::vector<Section> createLaunchPipelineAction(const Section& section, const std::vector<Section>& nextSections);
     void createWriteAction(const Section& section);
+    void createGenerateAction(const Section& section);
     void createCompareFilesAction(
             TestActionType actionType,
             const std::string& comparisonType,
@@ -60,9 +76,13 @@ private:
 
 private:
     std::vector<TestAction> actions_;
-    sfun::member<const std::vector<UserAction>> userActions_;
+    sfun::member<const UserActionList&> userActions_;
+    sfun::member<PortAllocator&> portAllocator_;
+    sfun::member<const std::filesystem::path> dataCacheDir_;
     sfun::member<const std::string> shellCommand_;
     sfun::member<const bool> cleanup_;
+    sfun::member<const bool> updateBaselines_;
+    sfun::member<sfun::optional_ref<TestCancellation>> cancellation_;
     std::filesystem::path directory_;
     std::string name_;
     std::string description_;
@@ -70,7 +90,12 @@ private:
     bool isEnabled_ = true;
     std::vector<FilenameGroup> contents_;
     std::optional<LaunchProcessResult> launchActionResult_;
+    // Declared before the detached processes, so the ports are released only after these processes are terminated
+    std::optional<AllocatedPorts> allocatedPorts_;
     std::vector<boost::process::child> detachedProcessList_;
+    std::set<std::filesystem::path> keptFailureReports_;
+    std::vector<std::filesystem::path> launchedExecutables_;
+    bool isInterrupted_ = false;
 };
 
 } //namespace lunchtoast
\ No newline at end of file
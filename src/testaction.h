@@ -1,6 +1,7 @@
 #pragma once
 #include "comparefilecontent.h"
 #include "comparefiles.h"
+#include "generatefile.h"
 #include "launchprocess.h"
 #include "testactiontype.h"
 #include "wait.h"
@@ -49,7 +50,7 @@ public:
     }
 
 private:
-    std::variant<CompareFileContent, CompareFiles, LaunchProcess, WriteFile, Wait> action_;
+    std::variant<CompareFileContent, CompareFiles, GenerateFile, LaunchPipeline, LaunchProcess, WriteFile, Wait> action_;
     TestActionType actionType_;
 };
 
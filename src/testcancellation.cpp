@@ -0,0 +1,62 @@
+#include "testcancellation.h"
+#ifndef _WIN32
+#include <csignal>
+#include <sys/types.h>
+#endif
+
+namespace lunchtoast {
+
+namespace {
+void killProcessGroup([[maybe_unused]] int processGroupId)
+{
+#ifndef _WIN32
+    ::kill(-processGroupId, SIGKILL);
+#endif
+}
+} //namespace
+
+void TestCancellation::cancel()
+{
+    auto lock = std::scoped_lock{mutex_};
+    isCancelled_ = true;
+    for (const auto processGroupId : processGroupIds_)
+        killProcessGroup(processGroupId);
+    cancelled_.notify_all();
+}
+
+bool TestCancellation::isCancelled() const
+{
+    auto lock = std::scoped_lock{mutex_};
+    return isCancelled_;
+}
+
+bool TestCancellation::waitFor(std::chrono::milliseconds timePeriod)
+{
+    auto lock = std::unique_lock{mutex_};
+    return !cancelled_.wait_for(
+            lock,
+            timePeriod,
+            [this]
+            {
+                return isCancelled_;
+            });
+}
+
+void TestCancellation::registerProcessGroup(int processGroupId)
+{
+    auto lock = std::scoped_lock{mutex_};
+    if (isCancelled_) {
+        killProcessGroup(processGroupId);
+        return;
+    }
+    processGroupIds_.insert(processGroupId);
+}
+
+// Process groups are unregistered before their leaders are reaped, so the reused process ids are never killed
+void TestCancellation::unregisterProcessGroup(int processGroupId)
+{
+    auto lock = std::scoped_lock{mutex_};
+    processGroupIds_.erase(processGroupId);
+}
+
+} //namespace lunchtoast
@@ -0,0 +1,28 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <set>
+
+namespace lunchtoast {
+
+// Stops the tests running in parallel when the testing is interrupted by reaching the failed tests limit.
+// Processes of these tests are launched in their own process groups, which are killed on the cancellation.
+class TestCancellation {
+public:
+    void cancel();
+    bool isCancelled() const;
+    // Returns false if the testing is cancelled before the end of the time period
+    bool waitFor(std::chrono::milliseconds timePeriod);
+    // Process groups registered after the cancellation are killed immediately
+    void registerProcessGroup(int processGroupId);
+    void unregisterProcessGroup(int processGroupId);
+
+private:
+    mutable std::mutex mutex_;
+    std::condition_variable cancelled_;
+    bool isCancelled_ = false;
+    std::set<int> processGroupIds_;
+};
+
+} //namespace lunchtoast
@@ -0,0 +1,46 @@
+#include "testdurations.h"
+#include <fmt/format.h>
+#include <sfun/path.h>
+#include <sfun/string_utils.h>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+namespace lunchtoast {
+namespace fs = std::filesystem;
+
+TestDurations readTestDurations(const fs::path& filePath)
+{
+    auto result = TestDurations{};
+    if (!fs::exists(filePath))
+        return result;
+
+    auto stream = std::ifstream{filePath};
+    auto line = std::string{};
+    while (std::getline(stream, line)) {
+        const auto durationStr = sfun::before(line, " ");
+        const auto testPath = sfun::after(line, " ");
+        if (!durationStr.has_value() || !testPath.has_value())
+            continue;
+        try {
+            result[std::string{sfun::trim(testPath.value())}] =
+                    std::chrono::milliseconds{std::stoll(std::string{durationStr.value()})};
+        }
+        catch (const std::logic_error&) {
+            throw std::runtime_error{fmt::format(
+                    "Test durations file {} contains an invalid line: {}\n",
+                    sfun::path_string(filePath),
+                    line)};
+        }
+    }
+    return result;
+}
+
+void writeTestDurations(const TestDurations& durations, const fs::path& filePath)
+{
+    auto stream = std::ofstream{filePath};
+    for (const auto& [testPath, duration] : durations)
+        stream << duration.count() << " " << testPath << std::endl;
+}
+
+} //namespace lunchtoast
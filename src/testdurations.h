@@ -0,0 +1,14 @@
+#pragma once
+#include <chrono>
+#include <filesystem>
+#include <map>
+#include <string>
+
+namespace lunchtoast {
+
+using TestDurations = std::map<std::string, std::chrono::milliseconds>;
+
+TestDurations readTestDurations(const std::filesystem::path& filePath);
+void writeTestDurations(const TestDurations& durations, const std::filesystem::path& filePath);
+
+} //namespace lunchtoast
@@ -2,24 +2,41 @@
 #include "commandline.h"
 #include "config.h"
 #include "constants.h"
+#include "copydirectory.h"
+#include "filewatcher.h"
 #include "errors.h"
+#include "fixture.h"
+#include "performancebaseline.h"
+#include "resourcescheduler.h"
+#include "scratchdirectory.h"
 #include "sectionsreader.h"
+#include "sharding.h"
+#include "shardresults.h"
 #include "test.h"
+#include "testcancellation.h"
 #include "testreporter.h"
 #include "useraction.h"
 #include "utils.h"
 #include <figcone/configreader.h>
+#include <fmt/format.h>
 #include <range/v3/range/conversion.hpp>
 #include <range/v3/view.hpp>
 #include <sfun/path.h>
 #include <sfun/string_utils.h>
 #include <sfun/utility.h>
+#include <gsl/util>
 #include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
 #include <fstream>
 #include <iterator>
+#include <mutex>
 #include <set>
+#include <thread>
 
 namespace lunchtoast {
+namespace fs = std::filesystem;
 namespace views = ranges::views;
 
 namespace {
@@ -32,10 +49,77 @@ std::vector<UserAction> makeUserActions(const Config& cfg)
     return cfg.actions | views::transform(toUserAction) | ranges::to<std::vector>;
 }
 
-} //namespace
+std::optional<int> getMaxFailedTests(const CommandLine& commandLine)
+{
+    if (commandLine.failFast)
+        return 1;
+    return commandLine.maxFailures;
+}
 
-namespace fs = std::filesystem;
-namespace views = ranges::views;
+std::optional<TagExpression> getTagExpression(const CommandLine& commandLine)
+{
+    if (commandLine.tagExpression.empty())
+        return std::nullopt;
+    return TagExpression{commandLine.tagExpression};
+}
+
+std::optional<int> getRepeatCount(const CommandLine& commandLine)
+{
+    if (commandLine.untilFail)
+        return commandLine.repeat;
+    return commandLine.repeat.has_value() ? commandLine.repeat : 1;
+}
+
+// Generated data is cached in the system temporary directory by default, so it's shared by all runs on the machine
+fs::path getDataCacheDir(const CommandLine& commandLine)
+{
+    if (!commandLine.dataCacheDir.empty())
+        return commandLine.dataCacheDir;
+    return fs::temp_directory_path() / "lunchtoast_data";
+}
+
+// Files of tests launched with the watch flag or by the daemon are tracked to update the tests after their changes
+bool isTrackingTestFiles(const CommandLine& commandLine)
+{
+    return commandLine.watch || !commandLine.daemonSocket.empty();
+}
+
+// Options affecting the collected tests, the plans written by other versions of lunchtoast are outdated too
+std::string getTestPlanCollectionOptions(const CommandLine& commandLine)
+{
+    return fmt::format(
+            "{}\t{}\t{}\t{}\t{}\t{}\t{}",
+            hardcoded::appVersion,
+            sfun::path_string(commandLine.testPath),
+            commandLine.searchDepth.has_value() ? std::to_string(commandLine.searchDepth.value()) : "",
+            sfun::join(commandLine.select, ","),
+            sfun::join(commandLine.skip, ","),
+            commandLine.tagExpression,
+            sfun::path_string(commandLine.config));
+}
+
+// Capacities set in the config replace the default ones and declare new counted resources
+std::map<std::string, std::int64_t> getResourceCapacities(const Config& cfg)
+{
+    auto result = defaultResourceCapacities();
+    for (const auto& [resourceName, capacityStr] : cfg.resourceCapacities) {
+        const auto capacity = readDataSize(capacityStr);
+        if (!capacity.has_value() || capacity.value() <= 0)
+            throw std::runtime_error{
+                    fmt::format("Invalid capacity of the resource '{}': {}\n", resourceName, capacityStr)};
+        result[resourceName] = capacity.value();
+    }
+    return result;
+}
+
+fs::path getTestRootDir(const fs::path& testPath)
+{
+    if (fs::is_directory(testPath))
+        return testPath;
+    return testPath.parent_path();
+}
+
+} //namespace
 
 TestLauncher::TestLauncher(const TestReporter& reporter, const CommandLine& commandLine, const Config& cfg)
     : reporter_{reporter}
@@ -43,14 +127,69 @@ TestLauncher::TestLauncher(const TestReporter& reporter, const CommandLine& comm
     , userActions_{makeUserActions(cfg)}
     , shellCommand_{commandLine.shell}
     , cleanup_{!commandLine.withoutCleanup}
+    , updateBaselines_{commandLine.updateBaselines}
     , selectedTags_{commandLine.select}
     , skippedTags_{commandLine.skip}
+    , tagExpression_{getTagExpression(commandLine)}
+    , tagIndexFile_{commandLine.tagIndex}
+    , testPlanFile_{commandLine.testPlan}
     , listOfFailedTests_{commandLine.listFailedTests}
     , dirWithFailedTests_{commandLine.collectFailedTests}
+    , maxFailedTests_{getMaxFailedTests(commandLine)}
+    , testRootDir_{getTestRootDir(commandLine.testPath)}
+    , testDurationsFile_{commandLine.testDurations}
+    , resultsFile_{commandLine.saveResults}
+    , isShard_{commandLine.shardCount.has_value()}
+    , scratchDir_{commandLine.scratchDir}
+    , dataCacheDir_{getDataCacheDir(commandLine)}
+    , repeatCount_{getRepeatCount(commandLine)}
+    , repeatUntilFail_{commandLine.untilFail}
+    , watch_{isTrackingTestFiles(commandLine)}
+    , searchDepth_{commandLine.searchDepth}
+    , jobsCount_{commandLine.jobs}
+    , resourceCapacities_{getResourceCapacities(cfg)}
 {
-    collectTests(commandLine.testPath, {}, commandLine.searchDepth);
+    if (!testDurationsFile_.get().empty())
+        testDurations_ = readTestDurations(testDurationsFile_);
+
+    if (!tagIndexFile_.get().empty())
+        tagIndex_ = readTagIndex(tagIndexFile_);
+
+    const auto testPlanCollectionOptions = getTestPlanCollectionOptions(commandLine);
+    if (testPlanFile_.get().empty() || !loadTestPlan(testPlanCollectionOptions)) {
+        if (!testPlanFile_.get().empty() && !commandLine.config.empty())
+            stampTestPlanFile(commandLine.config);
+        collectTests(commandLine.testPath, {}, commandLine.searchDepth);
+
+        if (!tagIndexFile_.get().empty()) {
+            // Entries of tests outside of the searched directories are kept, unless their files were removed
+            std::erase_if(
+                    tagIndex_,
+                    [](const auto& indexEntry)
+                    {
+                        return !fs::exists(sfun::make_path(indexEntry.first));
+                    });
+            writeTagIndex(tagIndex_, tagIndexFile_);
+        }
+        if (!testPlanFile_.get().empty()) {
+            testPlan_.collectionOptions = testPlanCollectionOptions;
+            testPlan_.defaultSuite = defaultSuite_;
+            testPlan_.suites = suites_;
+            writeTestPlan(testPlan_, testPlanFile_);
+        }
+    }
+    if (commandLine.shardCount.has_value())
+        selectShard(commandLine.shardIndex.value(), commandLine.shardCount.value());
+
+    // The daemon updates collected tests after changes of their files before processing the next requested test run
+    if (!commandLine.daemonSocket.empty() && FileWatcher::isSupported()) {
+        fileWatcher_ = std::make_unique<FileWatcher>();
+        watchTestFiles(*fileWatcher_);
+    }
 }
 
+TestLauncher::~TestLauncher() = default;
+
 const TestReporter& TestLauncher::reporter() const
 {
     return reporter_;
@@ -63,48 +202,113 @@ auto concat(TContainer& lhs, const TContainer& rhs)
     lhs.insert(lhs.end(), rhs.begin(), rhs.end());
 }
 
-void writePathList(const std::vector<fs::path>& pathList, const fs::path& outputFile)
-{
-    if (pathList.empty())
-        return;
-
-    auto stream = std::ofstream{outputFile};
-    for (const auto& path : pathList)
-        stream << sfun::replace(sfun::path_string(path.parent_path()), "\\", "/") << std::endl;
-}
-
-void copyDirList(const std::vector<fs::path>& pathList, const fs::path& targetDir)
+std::uintmax_t copyDirList(const std::vector<fs::path>& pathList, const fs::path& targetDir)
 {
     if (pathList.empty())
-        return;
+        return 0;
 
     if (!fs::exists(targetDir))
         fs::create_directory(targetDir);
 
-    for (const auto& path : pathList)
-        if (fs::is_directory(path))
-            fs::copy(path, targetDir / path.stem(), fs::copy_options::update_existing | fs::copy_options::recursive);
-        else
-            fs::copy(
-                    path.parent_path(),
-                    targetDir / path.parent_path().stem(),
-                    fs::copy_options::update_existing | fs::copy_options::recursive);
+    const auto toSourceAndTargetDirs = [&](const fs::path& path)
+    {
+        const auto dir = fs::is_directory(path) ? path : path.parent_path();
+        return std::pair{dir, targetDir / dir.stem()};
+    };
+    return copyDirectories(pathList | views::transform(toSourceAndTargetDirs) | ranges::to<std::vector>);
 }
 
 } //namespace
 
+void TestLauncher::selectShard(int shardIndex, int shardCount)
+{
+    auto suites = std::vector<TestSuite*>{&defaultSuite_};
+    for (auto& suite : suites_ | views::values)
+        suites.push_back(&suite);
+
+    // Tests without recorded durations are assumed to take an average time of the known ones
+    const auto defaultDuration = [&]
+    {
+        if (testDurations_.empty())
+            return std::chrono::milliseconds{1};
+        auto total = std::chrono::milliseconds{};
+        for (const auto& duration : testDurations_ | views::values)
+            total += duration;
+        return std::max(total / std::ssize(testDurations_), std::chrono::milliseconds{1});
+    }();
+    const auto testWeight = [&](const TestCfg& testCfg)
+    {
+        if (!testCfg.isEnabled)
+            return std::chrono::milliseconds{};
+        const auto it = testDurations_.find(testDurationKey(testCfg.path));
+        return it != testDurations_.end() ? it->second : defaultDuration;
+    };
+
+    auto weights = std::vector<std::chrono::milliseconds>{};
+    for (const auto suite : suites)
+        for (const auto& testCfg : suite->tests)
+            weights.push_back(testWeight(testCfg));
+
+    const auto testShards = distributeOverShards(weights, shardCount);
+    auto testIndex = std::size_t{0};
+    for (const auto suite : suites) {
+        auto shardTests = std::vector<TestCfg>{};
+        for (auto& testCfg : suite->tests)
+            if (testShards[testIndex++] == shardIndex)
+                shardTests.push_back(std::move(testCfg));
+
+        suite->tests = std::move(shardTests);
+        suite->disabledTestsCounter = static_cast<int>(std::ranges::count(suite->tests, false, &TestCfg::isEnabled));
+    }
+    std::erase_if(
+            suites_,
+            [](const auto& suitePair)
+            {
+                return suitePair.second.tests.empty();
+            });
+}
+
 bool TestLauncher::process()
 {
+    return processSuites(defaultSuite_, suites_);
+}
+
+bool TestLauncher::processSuites(TestSuite& defaultSuite, std::map<std::string, TestSuite>& suites)
+{
+    failedTestsCounter_ = 0;
+    collectedFailedTestsSize_ = 0;
     auto failedTests = std::vector<fs::path>{};
-    concat(failedTests, processSuite("", defaultSuite_));
-    for (auto& [suiteName, suite] : suites_)
-        concat(failedTests, processSuite(suiteName, suite));
+    auto results = ShardResults{};
+    const auto processSuiteTests = [&](const std::string& suiteName, TestSuite& suite)
+    {
+        const auto failedSuiteTests = processSuite(suiteName, suite);
+        concat(failedTests, failedSuiteTests);
+        if (!failedSuiteTests.empty())
+            results.failedTests[suiteName] = failedSuiteTests;
+    };
+    reporter().reportTestingStarted(expectedTestDurations(defaultSuite, suites));
+    processSuiteTests("", defaultSuite);
+    for (auto& [suiteName, suite] : suites)
+        processSuiteTests(suiteName, suite);
 
-    reporter().reportSummary(defaultSuite_, suites_);
+    if (isFailedTestsLimitReached())
+        reporter().reportStoppedTesting(maxFailedTests_.get().value());
+    reporter().reportSummary(defaultSuite, suites);
     if (!listOfFailedTests_.get().empty())
         writePathList(failedTests, listOfFailedTests_);
-    if (!dirWithFailedTests_.get().empty()) {
-        copyDirList(failedTests, dirWithFailedTests_);
+    // Failed tests launched in scratch directories are collected before their removal in processSuite()
+    if (!dirWithFailedTests_.get().empty() && scratchDir_.get().empty())
+        collectedFailedTestsSize_ += copyDirList(failedTests, dirWithFailedTests_);
+    if (!dirWithFailedTests_.get().empty() && !failedTests.empty())
+        reporter().reportCollectedFailedTests(collectedFailedTestsSize_);
+    // Shards only read the durations file, it's updated by the mergeResults command combining their results
+    if (!testDurationsFile_.get().empty() && !isShard_)
+        writeTestDurations(testDurations_, testDurationsFile_);
+    if (!resultsFile_.get().empty()) {
+        results.defaultSuite = defaultSuite;
+        results.suites = suites;
+        results.testDurations = testDurations_;
+        writeShardResults(results, resultsFile_);
     }
 
     return failedTests.empty();
@@ -113,31 +317,255 @@ bool TestLauncher::process()
 std::vector<std::filesystem::path> TestLauncher::processSuite(const std::string& suiteName, TestSuite& suite)
 {
     const auto testsCount = std::ssize(suite.tests);
-    auto testNumber = 0;
-    auto failedTests = std::vector<fs::path>{};
+    // Failed tests are listed in the suite order, regardless of the order in which they finish
+    auto failedTests = std::map<int, fs::path>{};
 
+    auto scheduler = ResourceScheduler{resourceCapacities_};
+    auto resourceErrors = std::vector<std::optional<std::string>>{};
     for (const auto& testCfg : suite.tests) {
-        testNumber++;
         try {
-            auto test = Test{testCfg.path, testCfg.vars, testCfg.userActions, shellCommand_, cleanup_};
-            if (!testCfg.isEnabled) {
-                reporter().reportDisabledTest(test, suiteName, testNumber, testsCount);
-                continue;
+            scheduler.addTask(scheduler.readRequirements(testCfg.resources));
+            resourceErrors.emplace_back();
+        }
+        catch (const TestConfigError& error) {
+            scheduler.addTask({});
+            resourceErrors.emplace_back(error.what());
+        }
+    }
+
+    // Fixtures are torn down on the destruction even if the testing is interrupted by an error
+    auto fixtures = SuiteFixtures{portAllocator_, shellCommand_};
+    addSuiteFixtures(fixtures, suite);
+
+    // Tests running in parallel are stopped when the failed tests limit is reached by one of them
+    const auto threadsCount = std::min<sfun::ssize_t>(jobsCount_, testsCount);
+    auto cancellation = TestCancellation{};
+    const auto testCancellation = (threadsCount > 1 && maxFailedTests_.get().has_value()) ? &cancellation : nullptr;
+
+    // Tests are launched without holding the lock and their results are reported with it,
+    // so the reports of the tests running in parallel aren't mixed
+    const auto processSuiteTest = [&](int testIndex, std::unique_lock<std::mutex>& lock)
+    {
+        const auto& testCfg = suite.tests.at(testIndex);
+        const auto testNumber = testIndex + 1;
+        if (isFailedTestsLimitReached()) {
+            if (testCfg.isEnabled)
+                suite.skippedTestsCounter++;
+            return;
+        }
+
+        if (!testCfg.isEnabled) {
+            reporter().reportDisabledTest(testCfg, suiteName, testNumber, testsCount);
+            return;
+        }
+
+        const auto testName = testDurationKey(testCfg.path);
+        reporter().reportTestStarted(testName);
+        auto scratchDir = std::optional<ScratchDirectory>{};
+        // Tests interrupted by the stop of the testing aren't reported, they're counted as skipped
+        const auto onTestStopped = [&]
+        {
+            reporter().reportTestFinished(testName, false);
+            suite.skippedTestsCounter++;
+        };
+        const auto onTestFailed = [&]
+        {
+            reporter().reportTestFinished(testName, true);
+            failedTests[testIndex] = testCfg.path;
+            failedTestsCounter_++;
+            if (isFailedTestsLimitReached())
+                cancellation.cancel();
+            if (scratchDir.has_value())
+                scratchDir->copyFailureReports();
+            if (scratchDir.has_value() && !dirWithFailedTests_.get().empty())
+                collectedFailedTestsSize_ += copyDirList({scratchDir->testDir()}, dirWithFailedTests_);
+        };
+
+        try {
+            if (resourceErrors.at(testIndex).has_value())
+                throw TestConfigError{resourceErrors.at(testIndex).value()};
+
+            auto test = std::optional<Test>{};
+            auto testResult = std::optional<std::tuple<TestResult, std::optional<TestIterationsStats>>>{};
+            auto testDuration = std::chrono::milliseconds{};
+            {
+                lock.unlock();
+                const auto relock = gsl::finally(
+                        [&]
+                        {
+                            lock.lock();
+                        });
+                auto testVars = testCfg.vars;
+                for (auto& [varName, varValue] : fixtures.setUp(testIndex))
+                    testVars.insert_or_assign(varName, std::move(varValue));
+                if (!scratchDir_.get().empty())
+                    scratchDir.emplace(scratchDir_, testCfg.path.parent_path());
+                const auto testCasePath =
+                        scratchDir.has_value() ? scratchDir->testDir() / testCfg.path.filename() : testCfg.path;
+                // Scratch directories are removed after testing, so test files don't need to be cleaned up
+                test.emplace(
+                        testCasePath,
+                        testVars,
+                        *testCfg.userActions,
+                        portAllocator_,
+                        dataCacheDir_,
+                        shellCommand_,
+                        cleanup_ && !scratchDir.has_value(),
+                        updateBaselines_,
+                        testCancellation);
+                const auto startTime = std::chrono::steady_clock::now();
+                testResult = processTest(test.value(), testCancellation);
+                testDuration = std::chrono::duration_cast<std::chrono::milliseconds>(
+                        std::chrono::steady_clock::now() - startTime);
             }
-            auto result = test.process();
-            if (result.type() == TestResultType::Success)
+            if (!testResult.has_value()) {
+                onTestStopped();
+                return;
+            }
+
+            const auto& [result, iterationsStats] = testResult.value();
+            if (watch_)
+                launchedExecutables_[testCfg.path] = test->launchedExecutables();
+            testDurations_[testName] = iterationsStats.has_value() ? iterationsStats->medianDuration : testDuration;
+            if (result.type() == TestResultType::Success) {
+                reporter().reportTestFinished(testName, false);
                 suite.passedTestsCounter++;
+            }
             else
-                failedTests.push_back(testCfg.path);
+                onTestFailed();
 
-            reporter().reportResult(test, result, suiteName, testNumber, testsCount);
+            reporter().reportResult(test.value(), result, suiteName, testNumber, testsCount, iterationsStats);
         }
-        catch (const TestConfigError& error) {
+        // Errors of the test environment, like a lack of free ports or a failed copying to the scratch directory,
+        // break only the current test
+        catch (const std::exception& error) {
             reporter().reportBrokenTest(testCfg.path, error.what(), suiteName, testNumber, testsCount);
-            failedTests.push_back(testCfg.path);
+            onTestFailed();
+        }
+    };
+
+    auto mutex = std::mutex{};
+    auto testFinished = std::condition_variable{};
+    auto error = std::exception_ptr{};
+    const auto processTests = [&]
+    {
+        auto lock = std::unique_lock{mutex};
+        while (!error) {
+            const auto testIndex = scheduler.startNextTask();
+            if (!testIndex.has_value()) {
+                if (!scheduler.hasPendingTasks())
+                    return;
+                testFinished.wait(lock);
+                continue;
+            }
+
+            try {
+                processSuiteTest(testIndex.value(), lock);
+            }
+            catch (...) {
+                if (!error)
+                    error = std::current_exception();
+            }
+            lock.unlock();
+            fixtures.finishTest(testIndex.value());
+            lock.lock();
+            scheduler.finishTask(testIndex.value());
+            testFinished.notify_all();
         }
+    };
+
+    auto threads = std::vector<std::thread>{};
+    for (auto i = sfun::ssize_t{1}; i < threadsCount; ++i)
+        threads.emplace_back(processTests);
+    processTests();
+    for (auto& thread : threads)
+        thread.join();
+
+    if (error)
+        std::rethrow_exception(error);
+    return failedTests | views::values | ranges::to<std::vector>;
+}
+
+std::optional<std::tuple<TestResult, std::optional<TestIterationsStats>>> TestLauncher::processTest(
+        Test& test,
+        sfun::optional_ref<TestCancellation> cancellation)
+{
+    if (repeatCount_.get() == 1) {
+        auto result = test.process();
+        if (test.wasInterrupted())
+            return std::nullopt;
+        return std::tuple{std::move(result), std::optional<TestIterationsStats>{}};
+    }
+
+    // The result of the first failed iteration is reported, as the following ones are often caused by it
+    auto result = std::optional<TestResult>{};
+    auto durations = std::vector<std::int64_t>{};
+    auto passedIterationsCount = 0;
+    for (auto iteration = 1; !repeatCount_.get().has_value() || iteration <= repeatCount_.get().value(); ++iteration) {
+        const auto startTime = std::chrono::steady_clock::now();
+        auto iterationResult = test.processIteration(iteration);
+        // The interrupted iteration is dropped, the test is reported by its finished iterations
+        if (test.wasInterrupted())
+            break;
+        const auto duration =
+                std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime);
+        durations.push_back(duration.count());
+
+        const auto isIterationSuccessful = (iterationResult.type() == TestResultType::Success);
+        if (isIterationSuccessful)
+            passedIterationsCount++;
+        if (!result.has_value() || (result->type() == TestResultType::Success && !isIterationSuccessful))
+            result = std::move(iterationResult);
+        if (repeatUntilFail_ && !isIterationSuccessful)
+            break;
+        if (cancellation.has_value() && cancellation->isCancelled())
+            break;
     }
-    return failedTests;
+
+    if (durations.empty())
+        return std::nullopt;
+
+    const auto [minDuration, maxDuration] = std::ranges::minmax(durations);
+    const auto stats = TestIterationsStats{
+            .iterationsCount = static_cast<int>(std::ssize(durations)),
+            .passedIterationsCount = passedIterationsCount,
+            .minDuration = std::chrono::milliseconds{minDuration},
+            .medianDuration = std::chrono::milliseconds{calculatePerformanceStats(durations).median},
+            .maxDuration = std::chrono::milliseconds{maxDuration}};
+    return std::tuple{result.value(), std::optional{stats}};
+}
+
+std::map<std::string, std::optional<std::chrono::milliseconds>> TestLauncher::expectedTestDurations(
+        const TestSuite& defaultSuite,
+        const std::map<std::string, TestSuite>& suites) const
+{
+    auto result = std::map<std::string, std::optional<std::chrono::milliseconds>>{};
+    const auto addSuiteTests = [&](const TestSuite& suite)
+    {
+        for (const auto& testCfg : suite.tests) {
+            if (!testCfg.isEnabled)
+                continue;
+            const auto testName = testDurationKey(testCfg.path);
+            const auto it = testDurations_.find(testName);
+            result[testName] = it != testDurations_.end() ? std::optional{it->second} : std::nullopt;
+        }
+    };
+    addSuiteTests(defaultSuite);
+    for (const auto& suite : suites | views::values)
+        addSuiteTests(suite);
+    return result;
+}
+
+std::string TestLauncher::testDurationKey(const fs::path& testFile) const
+{
+    return sfun::replace(sfun::path_string(fs::relative(testFile.parent_path(), testRootDir_)), "\\", "/");
+}
+
+bool TestLauncher::isFailedTestsLimitReached() const
+{
+    if (!maxFailedTests_.get().has_value())
+        return false;
+    return failedTestsCounter_ >= maxFailedTests_.get().value();
 }
 
 void TestLauncher::collectTests(
@@ -146,8 +574,15 @@ void TestLauncher::collectTests(
         std::optional<int> searchDirectoryLevels)
 {
     if (fs::is_directory(testPath)) {
-        if (fs::exists(testPath / hardcoded::configFilename))
+        if (watch_)
+            collectedDirs_.insert(testPath);
+        // Stamps are read before the files, so the changes made during the collection make the test plan outdated
+        if (!testPlanFile_.get().empty())
+            testPlan_.directories[testPath] = readDirectoryStamp(testPath);
+        if (fs::exists(testPath / hardcoded::configFilename)) {
             configList.emplace_back(testPath / hardcoded::configFilename);
+            stampTestPlanFile(configList.back());
+        }
 
         const auto end = fs::directory_iterator{};
         auto dirSet = std::set<fs::path>{};
@@ -189,12 +624,15 @@ std::string getSectionValue(std::string_view sectionName, const std::vector<lunc
 bool isTestSelected(
         const std::set<std::string>& testTags,
         const std::vector<std::string>& selectedTags,
-        const std::vector<std::string>& skippedTags)
+        const std::vector<std::string>& skippedTags,
+        const std::optional<TagExpression>& tagExpression)
 {
     auto isTestTaggedWith = [&](const std::string& tag)
     {
         return testTags.count(tag);
     };
+    if (tagExpression.has_value() && !tagExpression->isSatisfiedBy(testTags))
+        return false;
     if (!selectedTags.empty())
         if (std::none_of(selectedTags.begin(), selectedTags.end(), isTestTaggedWith))
             return false;
@@ -240,6 +678,33 @@ std::unordered_map<std::string, std::string> makeTestVariables(
     return result;
 }
 
+std::set<std::string> makeTestResources(const Config& config, const std::set<std::string>& tags)
+{
+    auto result = std::set<std::string>{};
+    for (const auto& tagResources : config.tagResources)
+        if (tags.contains(tagResources.tag))
+            std::ranges::copy(splitSectionValue(tagResources.resources), std::inserter(result, result.end()));
+    return result;
+}
+
+std::set<std::string> makeTestResources(const std::vector<fs::path>& configList, const std::set<std::string>& tags)
+{
+    if (tags.empty())
+        return {};
+    auto result = std::set<std::string>{};
+    auto configReader = figcone::ConfigReader{};
+    for (const auto& configPath : configList)
+        result.merge(makeTestResources(configReader.readShoalFile<Config>(configPath), tags));
+    return result;
+}
+
+std::vector<Section> readTestCaseSections(const fs::path& testFile)
+{
+    auto stream = std::ifstream{testFile, std::ios::binary};
+    auto error = SectionReadingError{};
+    return lunchtoast::readSections(stream, error);
+}
+
 std::vector<UserAction> makeUserActions(const std::vector<std::filesystem::path>& cfgList)
 {
     const auto readConfigActions = [](const fs::path& configPath)
@@ -259,9 +724,11 @@ std::vector<UserAction> makeUserActions(const std::vector<std::filesystem::path>
 
 void TestLauncher::addTest(const fs::path& testFile, const std::vector<std::filesystem::path>& configList)
 {
-    auto stream = std::ifstream{testFile, std::ios::binary};
-    auto error = SectionReadingError{};
-    const auto sections = lunchtoast::readSections(stream, error);
+    stampTestPlanFile(testFile);
+    // With the tag index, test case files of tests that aren't selected by their tags aren't read
+    const auto isUsingTagIndex = !tagIndexFile_.get().empty();
+    auto sections = isUsingTagIndex ? std::vector<Section>{} : readTestCaseSections(testFile);
+    const auto tagsValue = isUsingTagIndex ? indexedTestTags(testFile) : getSectionValue("Tags", sections);
 
     const auto makeTestVarsWithoutTags = [&]
     {
@@ -271,10 +738,15 @@ void TestLauncher::addTest(const fs::path& testFile, const std::vector<std::file
         return result;
     };
 
-    const auto tagsStr = processVariablesSubstitution(getSectionValue("Tags", sections), makeTestVarsWithoutTags());
+    // Config files are read for the variables substitution only when tags contain variables
+    const auto tagsStr = tagsValue.find("${{") != std::string::npos
+            ? processVariablesSubstitution(tagsValue, makeTestVarsWithoutTags())
+            : tagsValue;
     const auto tagsSet = splitSectionValue(tagsStr) | ranges::to<std::set>;
-    if (!isTestSelected(tagsSet, selectedTags_, skippedTags_))
+    if (!isTestSelected(tagsSet, selectedTags_, skippedTags_, tagExpression_))
         return;
+    if (isUsingTagIndex)
+        sections = readTestCaseSections(testFile);
 
     const auto testVars = [&]
     {
@@ -288,23 +760,405 @@ void TestLauncher::addTest(const fs::path& testFile, const std::vector<std::file
     const auto enabledStr = toLower(processVariablesSubstitution(getSectionValue("Enabled", sections), testVars));
     const auto isEnabled = (enabledStr.empty() || enabledStr == "true");
     const auto suiteName = processVariablesSubstitution(getSectionValue("Suite", sections), testVars);
-    const auto userActions = [&]
+    auto& suite = suiteName.empty() ? defaultSuite_ : suites_[suiteName];
+    if (isEnabled) {
+        auto resources =
+                splitSectionValue(processVariablesSubstitution(getSectionValue("Resources", sections), testVars)) |
+                ranges::to<std::set>;
+        resources.merge(makeTestResources(configList, tagsSet));
+        resources.merge(makeTestResources(config_, tagsSet));
+        suite.tests.push_back(
+                {testFile,
+                 isEnabled,
+                 testVars,
+                 userActionList(configList),
+                 configList,
+                 tagsSet,
+                 std::move(resources),
+                 {},
+                 {}});
+    }
+    else {
+        auto name = processVariablesSubstitution(getSectionValue("Name", sections), testVars);
+        if (name.empty())
+            name = sfun::path_string(testFile.parent_path().filename());
+        auto description = processVariablesSubstitution(getSectionValue("Description", sections), testVars);
+        suite.tests.push_back(
+                {testFile,
+                 isEnabled,
+                 testVars,
+                 nullptr,
+                 configList,
+                 tagsSet,
+                 {},
+                 std::move(name),
+                 std::move(description)});
+        suite.disabledTestsCounter++;
+    }
+}
+
+void TestLauncher::addSuiteFixtures(SuiteFixtures& fixtures, const TestSuite& suite)
+{
+    const auto hasCommandLineFixture = hasFixture(config_);
+    if (hasCommandLineFixture)
+        fixtures.addFixture(
+                {},
+                makeFixtureCfg(
+                        config_,
+                        testRootDir_,
+                        makeTestVariables(config_, {}, sfun::path_string(testRootDir_.get().stem()))));
+
+    // Fixtures are read on each launch of the suite, as config files can be changed in the watch mode
+    auto configReader = figcone::ConfigReader{};
+    auto configsWithFixture = std::map<fs::path, bool>{};
+    for (const auto& [testIndex, testCfg] : views::enumerate(suite.tests)) {
+        if (!testCfg.isEnabled)
+            continue;
+        auto testFixtures = std::vector<fs::path>{};
+        if (hasCommandLineFixture)
+            testFixtures.emplace_back();
+        for (const auto& [configIndex, configPath] : views::enumerate(testCfg.configList)) {
+            if (!configsWithFixture.contains(configPath)) {
+                const auto cfg = configReader.readShoalFile<Config>(configPath);
+                configsWithFixture[configPath] = hasFixture(cfg);
+                if (hasFixture(cfg)) {
+                    const auto configDir = configPath.parent_path();
+                    const auto parentConfigList =
+                            testCfg.configList | views::take(configIndex + 1) | ranges::to<std::vector>;
+                    auto vars = makeTestVariables(parentConfigList, {}, sfun::path_string(configDir.stem()));
+                    std::ranges::copy(
+                            makeTestVariables(config_, {}, sfun::path_string(configDir.stem())),
+                            std::inserter(vars, vars.begin()));
+                    fixtures.addFixture(configPath, makeFixtureCfg(cfg, configDir, std::move(vars)));
+                }
+            }
+            if (configsWithFixture.at(configPath))
+                testFixtures.push_back(configPath);
+        }
+        fixtures.addTest(static_cast<int>(testIndex), std::move(testFixtures));
+    }
+}
+
+void TestLauncher::stampTestPlanFile(const fs::path& file)
+{
+    if (testPlanFile_.get().empty())
+        return;
+    // A missing file gets an empty stamp, which makes the test plan outdated
+    testPlan_.files[file] = readFileStamp(file).value_or(FileStamp{});
+}
+
+bool TestLauncher::loadTestPlan(const std::string& collectionOptions)
+{
+    auto testPlan = readTestPlan(testPlanFile_);
+    if (!testPlan.has_value())
+        return false;
+    const auto testPlanState = checkTestPlan(testPlan.value(), collectionOptions);
+    if (testPlanState == TestPlanState::Outdated)
+        return false;
+    if (testPlanState == TestPlanState::UpdatedStamps)
+        writeTestPlan(testPlan.value(), testPlanFile_);
+
+    const auto restoreUserActions = [&](TestSuite& suite)
+    {
+        for (auto& testCfg : suite.tests)
+            if (testCfg.isEnabled)
+                testCfg.userActions = userActionList(testCfg.configList);
+    };
+    restoreUserActions(testPlan->defaultSuite);
+    for (auto& suite : testPlan->suites | views::values)
+        restoreUserActions(suite);
+
+    defaultSuite_ = testPlan->defaultSuite;
+    suites_ = testPlan->suites;
+    if (watch_)
+        for (const auto& dir : testPlan->directories | views::keys)
+            collectedDirs_.insert(dir);
+    testPlan_ = std::move(testPlan.value());
+    return true;
+}
+
+std::string TestLauncher::indexedTestTags(const fs::path& testFile)
+{
+    const auto modificationTime = static_cast<std::int64_t>(fs::last_write_time(testFile).time_since_epoch().count());
+    const auto fileSize = fs::file_size(testFile);
+    auto& entry = tagIndex_[sfun::path_string(testFile)];
+    if (entry.modificationTime != modificationTime || entry.fileSize != fileSize)
+        entry = TagIndexEntry{
+                .modificationTime = modificationTime,
+                .fileSize = fileSize,
+                .tags = getSectionValue("Tags", readTestCaseSections(testFile))};
+    return entry.tags;
+}
+
+void TestLauncher::sortTests()
+{
+    // Tests are collected in the order of their directory paths, which is restored after adding tests to the end
+    const auto sortSuiteTests = [](TestSuite& suite)
+    {
+        std::ranges::stable_sort(
+                suite.tests,
+                [](const fs::path& lhs, const fs::path& rhs)
+                {
+                    return lhs.parent_path() < rhs.parent_path();
+                },
+                &TestCfg::path);
+    };
+    sortSuiteTests(defaultSuite_);
+    for (auto& suite : suites_ | views::values)
+        sortSuiteTests(suite);
+}
+
+void TestLauncher::reloadTest(const fs::path& testFile, const std::vector<fs::path>& configList)
+{
+    const auto removeTest = [&](TestSuite& suite)
+    {
+        const auto it = std::ranges::find(suite.tests, testFile, &TestCfg::path);
+        if (it == suite.tests.end())
+            return;
+        if (!it->isEnabled)
+            suite.disabledTestsCounter--;
+        suite.tests.erase(it);
+    };
+    removeTest(defaultSuite_);
+    for (auto& suite : suites_ | views::values)
+        removeTest(suite);
+
+    if (fs::exists(testFile))
+        addTest(testFile, configList);
+
+    sortTests();
+    std::erase_if(
+            suites_,
+            [](const auto& suitePair)
+            {
+                return suitePair.second.tests.empty();
+            });
+}
+
+namespace {
+std::vector<fs::path> findConfigList(const fs::path& testDir, const fs::path& testRootDir)
+{
+    auto result = std::vector<fs::path>{};
+    for (auto dir = testDir; dir != dir.parent_path(); dir = dir.parent_path()) {
+        if (fs::exists(dir / hardcoded::configFilename))
+            result.insert(result.begin(), dir / hardcoded::configFilename);
+        if (dir == testRootDir)
+            break;
+    }
+    return result;
+}
+
+bool isInDirectory(const fs::path& path, const fs::path& dir)
+{
+    return std::ranges::mismatch(dir, path).in1 == dir.end();
+}
+
+} //namespace
+
+std::tuple<TestSuite, std::map<std::string, TestSuite>> TestLauncher::updateChangedTests(
+        const std::set<fs::path>& changedFiles)
+{
+    auto testsToReload = std::map<fs::path, std::vector<fs::path>>{};
+    auto affectedTests = std::set<fs::path>{};
+    const auto isLaunchedBy = [&](const TestCfg& testCfg, const fs::path& executable)
     {
-        auto result = makeUserActions(configList);
-        std::ranges::copy(userActions_.get(), std::inserter(result, result.begin()));
+        const auto it = launchedExecutables_.find(testCfg.path);
+        return it != launchedExecutables_.end() && std::ranges::find(it->second, executable) != it->second.end();
+    };
+    const auto forEachTest = [&](const std::function<void(const TestCfg&)>& func)
+    {
+        for (const auto& testCfg : defaultSuite_.tests)
+            func(testCfg);
+        for (const auto& suite : suites_ | views::values)
+            for (const auto& testCfg : suite.tests)
+                func(testCfg);
+    };
+
+    for (const auto& file : changedFiles) {
+        const auto fileName = sfun::path_string(file.filename());
+        if (fileName == hardcoded::configFilename)
+            std::erase_if(
+                    userActionListCache_,
+                    [&](const auto& cacheEntry)
+                    {
+                        return std::ranges::find(cacheEntry.first, file) != cacheEntry.first.end();
+                    });
+
+        forEachTest(
+                [&](const TestCfg& testCfg)
+                {
+                    const auto isConfigFile =
+                            std::ranges::find(testCfg.configList, file) != testCfg.configList.end();
+                    if (file == testCfg.path || isConfigFile)
+                        testsToReload.emplace(testCfg.path, testCfg.configList);
+                    // Creation or removal of a config file changes the config lists of the tests in its directory
+                    if (fileName == hardcoded::configFilename && isInDirectory(testCfg.path, file.parent_path())) {
+                        auto configList = findConfigList(testCfg.path.parent_path(), testRootDir_);
+                        if (configList != testCfg.configList)
+                            testsToReload.insert_or_assign(testCfg.path, std::move(configList));
+                    }
+                    if (file.parent_path() == testCfg.path.parent_path() || isLaunchedBy(testCfg, file))
+                        affectedTests.insert(testCfg.path);
+                });
+
+        // New test case files and directories are added without collecting the whole tree again
+        if (fileName == hardcoded::testCaseFilename && !testsToReload.contains(file) && fs::exists(file)) {
+            testsToReload.emplace(file, findConfigList(file.parent_path(), testRootDir_));
+            affectedTests.insert(file);
+        }
+        if (!collectedDirs_.contains(file) && collectedDirs_.contains(file.parent_path()) && fs::is_directory(file))
+            std::ranges::copy(collectNewTests(file), std::inserter(affectedTests, affectedTests.end()));
+    }
+
+    // Only the test case files affected by the changes are read again
+    for (const auto& [testFile, configList] : testsToReload) {
+        reloadTest(testFile, configList);
+        affectedTests.insert(testFile);
+    }
+
+    const auto selectAffectedTests = [&](const TestSuite& suite)
+    {
+        auto result = TestSuite{};
+        for (const auto& testCfg : suite.tests)
+            if (testCfg.isEnabled && affectedTests.contains(testCfg.path))
+                result.tests.push_back(testCfg);
         return result;
-    }();
+    };
+    auto affectedDefaultSuite = selectAffectedTests(defaultSuite_);
+    auto affectedSuites = std::map<std::string, TestSuite>{};
+    for (const auto& [suiteName, suite] : suites_) {
+        auto affectedSuite = selectAffectedTests(suite);
+        if (!affectedSuite.tests.empty())
+            affectedSuites.emplace(suiteName, std::move(affectedSuite));
+    }
+    return {std::move(affectedDefaultSuite), std::move(affectedSuites)};
+}
+
+std::vector<fs::path> TestLauncher::collectNewTests(const fs::path& dir)
+{
+    const auto dirLevel = std::ranges::distance(fs::relative(dir, testRootDir_));
+    if (searchDepth_.get().has_value() && dirLevel > searchDepth_.get().value())
+        return {};
+
+    const auto testsBefore = testFileSet();
+    collectTests(
+            dir,
+            findConfigList(dir.parent_path(), testRootDir_),
+            searchDepth_.get().has_value() ? std::optional{searchDepth_.get().value() - dirLevel} : std::nullopt);
+    sortTests();
+
+    auto newTests = std::vector<fs::path>{};
+    std::ranges::set_difference(testFileSet(), testsBefore, std::back_inserter(newTests));
+    return newTests;
+}
 
-    if (suiteName.empty()) {
-        defaultSuite_.tests.push_back({testFile, isEnabled, testVars, userActions});
-        if (!isEnabled)
-            defaultSuite_.disabledTestsCounter++;
+std::set<fs::path> TestLauncher::testFileSet() const
+{
+    auto result = std::set<fs::path>{};
+    for (const auto& testCfg : defaultSuite_.tests)
+        result.insert(testCfg.path);
+    for (const auto& suite : suites_ | views::values)
+        for (const auto& testCfg : suite.tests)
+            result.insert(testCfg.path);
+    return result;
+}
+
+void TestLauncher::watchTestFiles(FileWatcher& fileWatcher) const
+{
+    auto dirs = collectedDirs_;
+    const auto addTestDirs = [&](const TestSuite& suite)
+    {
+        // All directories containing the config files of a test are watched, so the created ones are detected
+        for (const auto& testCfg : suite.tests)
+            for (auto dir = testCfg.path.parent_path(); dir != dir.parent_path(); dir = dir.parent_path()) {
+                dirs.insert(dir);
+                if (dir == testRootDir_.get())
+                    break;
+            }
+    };
+    addTestDirs(defaultSuite_);
+    for (const auto& suite : suites_ | views::values)
+        addTestDirs(suite);
+    for (const auto& executables : launchedExecutables_ | views::values)
+        for (const auto& executable : executables)
+            dirs.insert(executable.parent_path());
+
+    for (const auto& dir : dirs)
+        if (fs::exists(dir))
+            fileWatcher.watchDirectory(dir);
+}
+
+void TestLauncher::watch()
+{
+    auto fileWatcher = FileWatcher{};
+    watchTestFiles(fileWatcher);
+    reporter().reportWatchingFiles();
+    while (true) {
+        const auto changedFiles = fileWatcher.waitForChanges(hardcoded::watchSettleTime);
+        auto [defaultSuite, suites] = updateChangedTests(changedFiles);
+        if (defaultSuite.tests.empty() && suites.empty())
+            continue;
+
+        reporter().reportChangedFiles(changedFiles);
+        processSuites(defaultSuite, suites);
+        // Changes made by the launched tests in their directories don't cause the tests to run again
+        fileWatcher.discardChanges();
+        watchTestFiles(fileWatcher);
+        reporter().reportWatchingFiles();
     }
-    else {
-        suites_[suiteName].tests.push_back({testFile, isEnabled, testVars, userActions});
-        if (!isEnabled)
-            suites_[suiteName].disabledTestsCounter++;
+}
+
+bool TestLauncher::processRequestedTests(
+        const std::vector<fs::path>& testPaths,
+        const std::vector<std::string>& selectedTags,
+        const std::vector<std::string>& skippedTags)
+{
+    if (fileWatcher_)
+        updateChangedTests(fileWatcher_->pendingChanges());
+
+    const auto isTestRequested = [&](const TestCfg& testCfg)
+    {
+        const auto isInTestPath = [&](const fs::path& testPath)
+        {
+            const auto relativePath = testCfg.path.lexically_relative(testPath);
+            return !relativePath.empty() && *relativePath.begin() != "..";
+        };
+        if (!testPaths.empty() && std::ranges::none_of(testPaths, isInTestPath))
+            return false;
+        return isTestSelected(testCfg.tags, selectedTags, skippedTags, std::nullopt);
+    };
+    const auto selectRequestedTests = [&](const TestSuite& suite)
+    {
+        auto result = TestSuite{};
+        std::ranges::copy_if(suite.tests, std::back_inserter(result.tests), isTestRequested);
+        result.disabledTestsCounter = static_cast<int>(std::ranges::count(result.tests, false, &TestCfg::isEnabled));
+        return result;
+    };
+    auto requestedDefaultSuite = selectRequestedTests(defaultSuite_);
+    auto requestedSuites = std::map<std::string, TestSuite>{};
+    for (const auto& [suiteName, suite] : suites_) {
+        auto requestedSuite = selectRequestedTests(suite);
+        if (!requestedSuite.tests.empty())
+            requestedSuites.emplace(suiteName, std::move(requestedSuite));
+    }
+
+    const auto allTestsPassed = processSuites(requestedDefaultSuite, requestedSuites);
+    if (fileWatcher_)
+        watchTestFiles(*fileWatcher_);
+    return allTestsPassed;
+}
+
+std::shared_ptr<const UserActionList> TestLauncher::userActionList(const std::vector<fs::path>& configList)
+{
+    // Tests from the same directory tree share the list of config files,
+    // so their actions are created and their format regexes are compiled only once
+    auto& userActionList = userActionListCache_[configList];
+    if (!userActionList) {
+        auto userActions = userActions_.get();
+        concat(userActions, makeUserActions(configList));
+        userActionList = std::make_shared<const UserActionList>(std::move(userActions));
     }
+    return userActionList;
 }
 
 } //namespace lunchtoast
\ No newline at end of file
@@ -1,17 +1,32 @@
 #pragma once
+#include "portallocator.h"
+#include "tagexpression.h"
+#include "tagindex.h"
+#include "testdurations.h"
+#include "testplan.h"
+#include "testresult.h"
 #include "testsuite.h"
 #include "useraction.h"
+#include "useractionlist.h"
 #include <sfun/member.h>
+#include <sfun/optional_ref.h>
+#include <chrono>
+#include <cstdint>
 #include <filesystem>
 #include <functional>
 #include <map>
+#include <memory>
 #include <optional>
+#include <set>
+#include <tuple>
 #include <vector>
 
 namespace lunchtoast {
 
+class FileWatcher;
+class SuiteFixtures;
 class Test;
-class TestResult;
+class TestCancellation;
 class TestReporter;
 struct CommandLine;
 struct Config;
@@ -19,7 +34,13 @@ struct Config;
 class TestLauncher {
 public:
     TestLauncher(const TestReporter&, const CommandLine&, const Config&);
+    ~TestLauncher();
     bool process();
+    void watch();
+    bool processRequestedTests(
+            const std::vector<std::filesystem::path>& testPaths,
+            const std::vector<std::string>& selectedTags,
+            const std::vector<std::string>& skippedTags);
 
 private:
     void collectTests(
@@ -27,7 +48,30 @@ private:
             std::vector<std::filesystem::path> configList,
             std::optional<int> searchDirectoryLevels);
     void addTest(const std::filesystem::path& testFile, const std::vector<std::filesystem::path>& configList);
+    bool loadTestPlan(const std::string& collectionOptions);
+    void stampTestPlanFile(const std::filesystem::path& file);
+    void sortTests();
+    void reloadTest(const std::filesystem::path& testFile, const std::vector<std::filesystem::path>& configList);
+    std::tuple<TestSuite, std::map<std::string, TestSuite>> updateChangedTests(
+            const std::set<std::filesystem::path>& changedFiles);
+    std::vector<std::filesystem::path> collectNewTests(const std::filesystem::path& dir);
+    std::set<std::filesystem::path> testFileSet() const;
+    void watchTestFiles(FileWatcher& fileWatcher) const;
+    std::shared_ptr<const UserActionList> userActionList(const std::vector<std::filesystem::path>& configList);
+    std::string indexedTestTags(const std::filesystem::path& testFile);
+    void selectShard(int shardIndex, int shardCount);
+    bool processSuites(TestSuite& defaultSuite, std::map<std::string, TestSuite>& suites);
     std::vector<std::filesystem::path> processSuite(const std::string& suiteName, TestSuite& suite);
+    void addSuiteFixtures(SuiteFixtures& fixtures, const TestSuite& suite);
+    // Returns nullopt if the test is interrupted by the cancellation of the testing
+    std::optional<std::tuple<TestResult, std::optional<TestIterationsStats>>> processTest(
+            Test& test,
+            sfun::optional_ref<TestCancellation> cancellation);
+    std::map<std::string, std::optional<std::chrono::milliseconds>> expectedTestDurations(
+            const TestSuite& defaultSuite,
+            const std::map<std::string, TestSuite>& suites) const;
+    std::string testDurationKey(const std::filesystem::path& testFile) const;
+    bool isFailedTestsLimitReached() const;
     const TestReporter& reporter() const;
 
 private:
@@ -38,10 +82,37 @@ private:
     sfun::member<const std::vector<UserAction>> userActions_;
     sfun::member<const std::string> shellCommand_;
     sfun::member<const bool> cleanup_;
+    sfun::member<const bool> updateBaselines_;
     sfun::member<const std::vector<std::string>> selectedTags_;
     sfun::member<const std::vector<std::string>> skippedTags_;
+    sfun::member<const std::optional<TagExpression>> tagExpression_;
+    sfun::member<const std::filesystem::path> tagIndexFile_;
+    sfun::member<const std::filesystem::path> testPlanFile_;
     sfun::member<const std::filesystem::path> listOfFailedTests_;
     sfun::member<const std::filesystem::path> dirWithFailedTests_;
+    sfun::member<const std::optional<int>> maxFailedTests_;
+    sfun::member<const std::filesystem::path> testRootDir_;
+    sfun::member<const std::filesystem::path> testDurationsFile_;
+    sfun::member<const std::filesystem::path> resultsFile_;
+    sfun::member<const bool> isShard_;
+    sfun::member<const std::filesystem::path> scratchDir_;
+    sfun::member<const std::filesystem::path> dataCacheDir_;
+    sfun::member<const std::optional<int>> repeatCount_;
+    sfun::member<const bool> repeatUntilFail_;
+    sfun::member<const bool> watch_;
+    sfun::member<const std::optional<int>> searchDepth_;
+    sfun::member<const int> jobsCount_;
+    sfun::member<const std::map<std::string, std::int64_t>> resourceCapacities_;
+    PortAllocator portAllocator_;
+    TestDurations testDurations_;
+    TagIndex tagIndex_;
+    TestPlan testPlan_;
+    std::map<std::vector<std::filesystem::path>, std::shared_ptr<const UserActionList>> userActionListCache_;
+    std::map<std::filesystem::path, std::vector<std::filesystem::path>> launchedExecutables_;
+    std::set<std::filesystem::path> collectedDirs_;
+    std::unique_ptr<FileWatcher> fileWatcher_;
+    int failedTestsCounter_ = 0;
+    std::uintmax_t collectedFailedTestsSize_ = 0;
 };
 
 } //namespace lunchtoast
\ No newline at end of file
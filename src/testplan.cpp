@@ -0,0 +1,289 @@
+#include "testplan.h"
+#include "constants.h"
+#include "utils.h"
+#include <sfun/path.h>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#ifdef __linux__
+#include <sys/stat.h>
+#endif
+
+namespace lunchtoast {
+namespace fs = std::filesystem;
+
+namespace {
+// Values of variables, names and descriptions can contain line breaks and tabs
+std::string escapeField(const std::string& value)
+{
+    auto result = std::string{};
+    result.reserve(value.size());
+    for (auto ch : value) {
+        switch (ch) {
+        case '\\':
+            result += "\\\\";
+            break;
+        case '\t':
+            result += "\\t";
+            break;
+        case '\n':
+            result += "\\n";
+            break;
+        case '\r':
+            result += "\\r";
+            break;
+        default:
+            result += ch;
+        }
+    }
+    return result;
+}
+
+std::string unescapeField(const std::string& value)
+{
+    auto result = std::string{};
+    result.reserve(value.size());
+    for (auto it = value.begin(); it != value.end(); ++it) {
+        if (*it != '\\') {
+            result += *it;
+            continue;
+        }
+        if (++it == value.end())
+            throw std::invalid_argument{value};
+        switch (*it) {
+        case '\\':
+            result += '\\';
+            break;
+        case 't':
+            result += '\t';
+            break;
+        case 'n':
+            result += '\n';
+            break;
+        case 'r':
+            result += '\r';
+            break;
+        default:
+            throw std::invalid_argument{value};
+        }
+    }
+    return result;
+}
+
+fs::path readPathField(const std::string& value)
+{
+    return sfun::make_path(unescapeField(value));
+}
+
+void writeStamp(std::ostream& stream, const std::string& type, const fs::path& path, const FileStamp& stamp)
+{
+    stream << type << "\t" << stamp.modificationTime << "\t" << stamp.changeTime << "\t" << stamp.fileSize << "\t"
+           << escapeField(sfun::path_string(path));
+}
+
+FileStamp readStamp(const std::vector<std::string>& fields)
+{
+    return FileStamp{
+            .modificationTime = std::stoll(fields.at(1)),
+            .changeTime = std::stoll(fields.at(2)),
+            .fileSize = std::stoull(fields.at(3))};
+}
+
+std::string readDirectoryEntries(const fs::path& dir)
+{
+    // Entries are listed the same way as in TestLauncher::collectTests()
+    auto entries = std::vector<std::string>{};
+    auto error = std::error_code{};
+    for (auto it = fs::directory_iterator{dir, error}; !error && it != fs::directory_iterator{}; it.increment(error)) {
+        const auto fileName = sfun::path_string(it->path().filename());
+        if (fs::is_directory(it->status()))
+            entries.push_back(fileName + "/");
+        else if (fileName == hardcoded::testCaseFilename || fileName == hardcoded::configFilename)
+            entries.push_back(fileName);
+    }
+    std::ranges::sort(entries);
+    auto result = std::string{};
+    for (const auto& entry : entries)
+        result += entry + "\n";
+    return result;
+}
+
+void writeSuite(std::ostream& stream, const std::string& suiteName, const TestSuite& suite)
+{
+    stream << "suite\t" << escapeField(suiteName) << "\n";
+    for (const auto& testCfg : suite.tests) {
+        stream << "test\t" << (testCfg.isEnabled ? 1 : 0) << "\t" << escapeField(sfun::path_string(testCfg.path))
+               << "\t" << escapeField(testCfg.name) << "\t" << escapeField(testCfg.description) << "\n";
+        for (const auto& configPath : testCfg.configList)
+            stream << "config\t" << escapeField(sfun::path_string(configPath)) << "\n";
+        for (const auto& tag : testCfg.tags)
+            stream << "tag\t" << escapeField(tag) << "\n";
+        for (const auto& resource : testCfg.resources)
+            stream << "resource\t" << escapeField(resource) << "\n";
+        // Variables are sorted to keep the plan file the same for the same tests
+        auto vars = std::vector<std::pair<std::string, std::string>>{testCfg.vars.begin(), testCfg.vars.end()};
+        std::ranges::sort(vars);
+        for (const auto& [varName, varValue] : vars)
+            stream << "var\t" << escapeField(varName) << "\t" << escapeField(varValue) << "\n";
+    }
+}
+
+} //namespace
+
+std::optional<FileStamp> readFileStamp(const fs::path& path)
+{
+#ifdef __linux__
+    struct stat fileStatus = {};
+    if (::stat(path.c_str(), &fileStatus) != 0)
+        return std::nullopt;
+    const auto toNanoseconds = [](const timespec& time)
+    {
+        return static_cast<std::int64_t>(time.tv_sec) * 1'000'000'000 + time.tv_nsec;
+    };
+    return FileStamp{
+            .modificationTime = toNanoseconds(fileStatus.st_mtim),
+            .changeTime = toNanoseconds(fileStatus.st_ctim),
+            .fileSize = S_ISDIR(fileStatus.st_mode) ? 0 : static_cast<std::uintmax_t>(fileStatus.st_size)};
+#else
+    auto error = std::error_code{};
+    const auto modificationTime = fs::last_write_time(path, error);
+    if (error)
+        return std::nullopt;
+    const auto isDirectory = fs::is_directory(path, error);
+    const auto fileSize = isDirectory ? std::uintmax_t{0} : fs::file_size(path, error);
+    if (error)
+        return std::nullopt;
+    return FileStamp{
+            .modificationTime = static_cast<std::int64_t>(modificationTime.time_since_epoch().count()),
+            .changeTime = 0,
+            .fileSize = fileSize};
+#endif
+}
+
+DirectoryStamp readDirectoryStamp(const fs::path& dir)
+{
+    return DirectoryStamp{.stamp = readFileStamp(dir).value_or(FileStamp{}), .entries = readDirectoryEntries(dir)};
+}
+
+std::optional<TestPlan> readTestPlan(const fs::path& filePath)
+{
+    auto stream = std::ifstream{filePath};
+    if (!stream.is_open())
+        return std::nullopt;
+
+    auto result = TestPlan{};
+    auto currentSuite = static_cast<TestSuite*>(nullptr);
+    auto line = std::string{};
+    auto linesCount = std::size_t{};
+    auto hasTrailer = false;
+    try {
+        while (std::getline(stream, line)) {
+            if (hasTrailer)
+                return std::nullopt;
+            const auto fields = readTabSeparatedFields(line);
+            const auto& type = fields.at(0);
+            if (type == "end" && fields.size() == 2) {
+                if (std::stoull(fields.at(1)) != linesCount)
+                    return std::nullopt;
+                hasTrailer = true;
+                continue;
+            }
+            linesCount++;
+            if (type == "options" && fields.size() == 2)
+                result.collectionOptions = unescapeField(fields.at(1));
+            else if (type == "directory" && fields.size() == 6)
+                result.directories[readPathField(fields.at(4))] =
+                        DirectoryStamp{.stamp = readStamp(fields), .entries = unescapeField(fields.at(5))};
+            else if (type == "file" && fields.size() == 5)
+                result.files[readPathField(fields.at(4))] = readStamp(fields);
+            else if (type == "suite" && fields.size() == 2) {
+                const auto suiteName = unescapeField(fields.at(1));
+                currentSuite = suiteName.empty() ? &result.defaultSuite : &result.suites[suiteName];
+            }
+            else if (type == "test" && fields.size() == 5 && currentSuite) {
+                auto& testCfg = currentSuite->tests.emplace_back();
+                testCfg.isEnabled = (fields.at(1) == "1");
+                testCfg.path = readPathField(fields.at(2));
+                testCfg.name = unescapeField(fields.at(3));
+                testCfg.description = unescapeField(fields.at(4));
+                if (!testCfg.isEnabled)
+                    currentSuite->disabledTestsCounter++;
+            }
+            else if (type == "config" && fields.size() == 2 && currentSuite && !currentSuite->tests.empty())
+                currentSuite->tests.back().configList.emplace_back(readPathField(fields.at(1)));
+            else if (type == "tag" && fields.size() == 2 && currentSuite && !currentSuite->tests.empty())
+                currentSuite->tests.back().tags.insert(unescapeField(fields.at(1)));
+            else if (type == "resource" && fields.size() == 2 && currentSuite && !currentSuite->tests.empty())
+                currentSuite->tests.back().resources.insert(unescapeField(fields.at(1)));
+            else if (type == "var" && fields.size() == 3 && currentSuite && !currentSuite->tests.empty())
+                currentSuite->tests.back().vars[unescapeField(fields.at(1))] = unescapeField(fields.at(2));
+            else
+                return std::nullopt;
+        }
+    }
+    catch (const std::logic_error&) {
+        return std::nullopt;
+    }
+    if (!hasTrailer)
+        return std::nullopt;
+    return result;
+}
+
+void writeTestPlan(const TestPlan& plan, const fs::path& filePath)
+{
+    auto content = std::ostringstream{};
+    content << "options\t" << escapeField(plan.collectionOptions) << "\n";
+    for (const auto& [path, directoryStamp] : plan.directories) {
+        writeStamp(content, "directory", path, directoryStamp.stamp);
+        content << "\t" << escapeField(directoryStamp.entries) << "\n";
+    }
+    for (const auto& [path, stamp] : plan.files) {
+        writeStamp(content, "file", path, stamp);
+        content << "\n";
+    }
+
+    writeSuite(content, "", plan.defaultSuite);
+    for (const auto& [suiteName, suite] : plan.suites)
+        writeSuite(content, suiteName, suite);
+
+    const auto planContent = content.str();
+    writeFileAtomically(
+            filePath,
+            [&](std::ostream& stream)
+            {
+                // The trailer with the number of lines lets the reader detect a truncated plan
+                stream << planContent << "end\t" << std::ranges::count(planContent, '\n') << "\n";
+            });
+}
+
+TestPlanState checkTestPlan(TestPlan& plan, const std::string& collectionOptions)
+{
+    if (plan.collectionOptions != collectionOptions)
+        return TestPlanState::Outdated;
+
+    const auto isStampUnchanged = [](const auto& pathAndStamp)
+    {
+        return readFileStamp(pathAndStamp.first) == pathAndStamp.second;
+    };
+    if (!std::ranges::all_of(plan.files, isStampUnchanged))
+        return TestPlanState::Outdated;
+
+    auto result = TestPlanState::UpToDate;
+    for (auto& [dir, directoryStamp] : plan.directories) {
+        const auto stamp = readFileStamp(dir);
+        if (!stamp.has_value())
+            return TestPlanState::Outdated;
+        if (stamp == directoryStamp.stamp)
+            continue;
+        if (readDirectoryEntries(dir) != directoryStamp.entries)
+            return TestPlanState::Outdated;
+        directoryStamp.stamp = stamp.value();
+        result = TestPlanState::UpdatedStamps;
+    }
+    return result;
+}
+
+} //namespace lunchtoast
@@ -0,0 +1,53 @@
+#pragma once
+#include "testsuite.h"
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <string>
+
+namespace lunchtoast {
+
+struct FileStamp {
+    std::int64_t modificationTime = 0;
+    // The status change time can't be set by the user, so it detects changes that keep the modification time,
+    // it's zero on platforms where it isn't available
+    std::int64_t changeTime = 0;
+    std::uintmax_t fileSize = 0;
+
+    friend bool operator==(const FileStamp&, const FileStamp&) = default;
+};
+
+struct DirectoryStamp {
+    FileStamp stamp;
+    // Subdirectories, test case and config files, as only they affect the collected tests
+    std::string entries;
+};
+
+// Collected tests stored together with the stamps of the searched directories, test case files and config files.
+// User action lists aren't stored and must be restored from the config lists of the loaded tests.
+struct TestPlan {
+    std::string collectionOptions;
+    std::map<std::filesystem::path, DirectoryStamp> directories;
+    std::map<std::filesystem::path, FileStamp> files;
+    TestSuite defaultSuite;
+    std::map<std::string, TestSuite> suites;
+};
+
+enum class TestPlanState {
+    UpToDate,
+    UpdatedStamps,
+    Outdated
+};
+
+std::optional<FileStamp> readFileStamp(const std::filesystem::path& path);
+DirectoryStamp readDirectoryStamp(const std::filesystem::path& dir);
+// Returns an empty optional when the plan file doesn't exist or can't be read, so the tests are collected again
+std::optional<TestPlan> readTestPlan(const std::filesystem::path& filePath);
+void writeTestPlan(const TestPlan& plan, const std::filesystem::path& filePath);
+// The plan is outdated when the collection options, test case or config files, or the entries of the searched
+// directories were changed. Launched tests write files in their directories, so the directories with
+// a changed modification time are read again, and their stamps are updated when the entries are the same.
+TestPlanState checkTestPlan(TestPlan& plan, const std::string& collectionOptions);
+
+} //namespace lunchtoast
@@ -1,16 +1,24 @@
 #include "testreporter.h"
+#include "constants.h"
+#include "progressdisplay.h"
 #include "test.h"
 #include "testresult.h"
 #include "utils.h"
+#include <range/v3/range/conversion.hpp>
 #include <range/v3/view.hpp>
 #include <sfun/path.h>
 #include <sfun/string_utils.h>
 #include <sfun/utility.h>
+#include <spdlog/async.h>
 #include <spdlog/logger.h>
 #include <spdlog/pattern_formatter.h>
+#include <spdlog/sinks/base_sink.h>
 #include <spdlog/sinks/basic_file_sink.h>
+#include <spdlog/sinks/sink.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <spdlog/spdlog.h>
+#include <cstdlib>
+#include <exception>
 
 namespace lunchtoast {
 namespace views = ranges::views;
@@ -50,6 +58,23 @@ void printNewLine()
     print(" ");
 }
 
+// Report lines are written by the thread of the async logger,
+// flushing after each test block keeps the console output up to date without blocking the testing
+void flushReport()
+{
+    spdlog::default_logger_raw()->flush();
+}
+
+std::terminate_handler previousTerminateHandler = nullptr;
+
+void flushReportAndTerminate()
+{
+    spdlog::shutdown();
+    if (previousTerminateHandler)
+        previousTerminateHandler();
+    std::abort();
+}
+
 std::string truncateString(std::string str, int maxWidth)
 {
     if (std::ssize(str) < 4)
@@ -61,44 +86,174 @@ std::string truncateString(std::string str, int maxWidth)
     return str;
 }
 
-void initReporter(const fs::path& reportFilePath)
+class ProgressDisplaySink : public spdlog::sinks::sink {
+public:
+    ProgressDisplaySink(std::shared_ptr<spdlog::sinks::sink> sink, ProgressDisplay& progressDisplay)
+        : sink_{std::move(sink)}
+        , progressDisplay_{progressDisplay}
+    {
+    }
+
+    void log(const spdlog::details::log_msg& msg) override
+    {
+        progressDisplay_.write(
+                [&]
+                {
+                    sink_->log(msg);
+                });
+    }
+
+    void flush() override
+    {
+        progressDisplay_.write(
+                [&]
+                {
+                    sink_->flush();
+                });
+    }
+
+    void set_pattern(const std::string& pattern) override
+    {
+        sink_->set_pattern(pattern);
+    }
+
+    void set_formatter(std::unique_ptr<spdlog::formatter> formatter) override
+    {
+        sink_->set_formatter(std::move(formatter));
+    }
+
+private:
+    std::shared_ptr<spdlog::sinks::sink> sink_;
+    ProgressDisplay& progressDisplay_;
+};
+
+class OutputHandlerSink : public spdlog::sinks::base_sink<spdlog::details::null_mutex> {
+public:
+    explicit OutputHandlerSink(std::function<void(std::string_view)> outputHandler)
+        : outputHandler_{std::move(outputHandler)}
+    {
+    }
+
+protected:
+    void sink_it_(const spdlog::details::log_msg& msg) override
+    {
+        auto formattedMsg = spdlog::memory_buf_t{};
+        formatter_->format(msg, formattedMsg);
+        outputHandler_(std::string_view{formattedMsg.data(), formattedMsg.size()});
+    }
+
+    void flush_() override
+    {
+    }
+
+private:
+    std::function<void(std::string_view)> outputHandler_;
+};
+
+void initReporter(const fs::path& reportFilePath, ProgressDisplay* progressDisplay, bool isSynchronous)
 {
-    auto makeConsoleSink = []
+    auto makeConsoleSink = [progressDisplay]() -> std::shared_ptr<spdlog::sinks::sink>
     {
-        auto sink = std::make_shared<spdlog::sinks::stdout_color_sink_st>();
+        auto sink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
         sink->set_level(spdlog::level::trace);
         sink->set_pattern("%^%v%$");
-        return sink;
+        if (!progressDisplay)
+            return sink;
+
+        auto progressDisplaySink = std::make_shared<ProgressDisplaySink>(sink, *progressDisplay);
+        progressDisplaySink->set_level(spdlog::level::trace);
+        return progressDisplaySink;
     };
     auto makeFileSink = [](const fs::path& logFilePath)
     {
-        auto sink = std::make_shared<spdlog::sinks::basic_file_sink_st>(sfun::path_string(logFilePath), true);
+        auto sink = std::make_shared<spdlog::sinks::basic_file_sink_mt>(sfun::path_string(logFilePath), true);
         sink->set_level(spdlog::level::trace);
         sink->set_pattern("%v");
         return sink;
     };
 
+    auto sinks = std::vector<spdlog::sink_ptr>{makeConsoleSink()};
+    if (!reportFilePath.empty())
+        sinks.push_back(makeFileSink(reportFilePath));
+
+    // Lines queued in the async logger are lost when the process is interrupted by a signal,
+    // so the reports of runs usually ended with Ctrl+C are written synchronously
     auto logger = std::shared_ptr<spdlog::logger>{};
+    if (isSynchronous)
+        logger = std::make_shared<spdlog::logger>("reporter", sinks.begin(), sinks.end());
+    else {
+        spdlog::init_thread_pool(hardcoded::reportQueueSize, 1);
+        logger = std::make_shared<spdlog::async_logger>(
+                "reporter",
+                sinks.begin(),
+                sinks.end(),
+                spdlog::thread_pool(),
+                spdlog::async_overflow_policy::block);
+    }
 
-    if (reportFilePath.empty())
-        logger = std::make_shared<spdlog::logger>("reporter", spdlog::sinks_init_list{makeConsoleSink()});
+    logger->set_level(spdlog::level::trace);
+    spdlog::set_default_logger(logger);
+}
 
-    else
-        logger = std::make_shared<spdlog::logger>(
-                "reporter",
-                spdlog::sinks_init_list{makeConsoleSink(), makeFileSink(reportFilePath)});
+void initReporter(std::function<void(std::string_view)> outputHandler)
+{
+    auto sink = std::make_shared<OutputHandlerSink>(std::move(outputHandler));
+    sink->set_level(spdlog::level::trace);
+    sink->set_pattern("%v");
 
+    // The synchronous logger passes all report lines to the handler before the end of the test run
+    auto logger = std::make_shared<spdlog::logger>("reporter", std::move(sink));
     logger->set_level(spdlog::level::trace);
-    logger->flush_on(spdlog::level::trace);
     spdlog::set_default_logger(logger);
 }
 
 } //namespace
 
-TestReporter::TestReporter(const fs::path& reportFilePath, int reportWidth)
+TestReporter::TestReporter(
+        const fs::path& reportFilePath,
+        int reportWidth,
+        bool showProgress,
+        bool isSynchronous)
+    : reportWidth_(reportWidth)
+{
+    // The progress status line is shown only in terminals
+    if (showProgress && ProgressDisplay::isSupported())
+        progressDisplay_ = std::make_unique<ProgressDisplay>();
+    initReporter(reportFilePath, progressDisplay_.get(), isSynchronous);
+    previousTerminateHandler = std::set_terminate(flushReportAndTerminate);
+}
+
+TestReporter::TestReporter(std::function<void(std::string_view)> outputHandler, int reportWidth)
     : reportWidth_(reportWidth)
 {
-    initReporter(reportFilePath);
+    initReporter(std::move(outputHandler));
+    previousTerminateHandler = std::set_terminate(flushReportAndTerminate);
+}
+
+TestReporter::~TestReporter()
+{
+    // Shutting down waits for the logger thread to write all queued report lines
+    spdlog::shutdown();
+    std::set_terminate(previousTerminateHandler);
+}
+
+void TestReporter::reportTestingStarted(
+        std::map<std::string, std::optional<std::chrono::milliseconds>> expectedTestDurations) const
+{
+    if (progressDisplay_)
+        progressDisplay_->start(std::move(expectedTestDurations));
+}
+
+void TestReporter::reportTestStarted(const std::string& testName) const
+{
+    if (progressDisplay_)
+        progressDisplay_->onTestStarted(testName);
+}
+
+void TestReporter::reportTestFinished(const std::string& testName, bool isFailed) const
+{
+    if (progressDisplay_)
+        progressDisplay_->onTestFinished(testName, isFailed);
 }
 
 void TestReporter::reportResult(
@@ -106,7 +261,8 @@ void TestReporter::reportResult(
         const TestResult& result,
         std::string suiteName,
         int suiteTestNumber,
-        sfun::ssize_t suiteNumOfTests) const
+        sfun::ssize_t suiteNumOfTests,
+        const std::optional<TestIterationsStats>& iterationsStats) const
 {
     suiteName = truncateString(suiteName, reportWidth_ / 2);
     auto header = fmt::format(" {} [ {} / {} ] ", suiteName, suiteTestNumber, suiteNumOfTests);
@@ -115,6 +271,18 @@ void TestReporter::reportResult(
 
     print(result.type(), fmt::runtime("{:#^" + std::to_string(reportWidth_) + "}"), header);
     print("Name: {}", test.name());
+    if (iterationsStats.has_value()) {
+        print(
+                "Iterations: {} out of {} passed ({}%)",
+                iterationsStats->passedIterationsCount,
+                iterationsStats->iterationsCount,
+                iterationsStats->passedIterationsCount * 100 / iterationsStats->iterationsCount);
+        print(
+                "Duration: min {} ms, median {} ms, max {} ms",
+                iterationsStats->minDuration.count(),
+                iterationsStats->medianDuration.count(),
+                iterationsStats->maxDuration.count());
+    }
     if (result.type() != TestResultType::Success) {
         if (!test.description().empty()) {
             const auto nextLines = sfun::after(test.description(), "\n");
@@ -136,6 +304,7 @@ void TestReporter::reportResult(
             lunchtoast::print(fmt::runtime(result.errorInfo()));
     const auto resultStr = fmt::format("Result: {:>10}", testResultStr(result.type()));
     print(result.type(), fmt::runtime("{:>" + std::to_string(reportWidth_) + "}"), resultStr);
+    flushReport();
 }
 
 void TestReporter::reportBrokenTest(
@@ -152,10 +321,11 @@ void TestReporter::reportBrokenTest(
 
     print(TestResultType::Failure, fmt::runtime("{:#^" + std::to_string(reportWidth_) + "}"), header);
     print("Test can't be started. Config file {} error:\n{}\n", homePathString(brokenTestConfig), errorInfo);
+    flushReport();
 }
 
 void TestReporter::reportDisabledTest(
-        const Test& test,
+        const TestCfg& testCfg,
         std::string suiteName,
         int suiteTestNumber,
         sfun::ssize_t suiteNumOfTests) const
@@ -165,33 +335,71 @@ void TestReporter::reportDisabledTest(
     if (suiteName.empty())
         header = header.substr(1);
     lunchtoast::print(fmt::runtime("{:#^" + std::to_string(reportWidth_) + "}"), header);
-    print("Name: {}", test.name());
+    print("Name: {}", testCfg.name);
 
-    if (!test.description().empty()) {
-        const auto nextLines = sfun::after(test.description(), "\n");
+    if (!testCfg.description.empty()) {
+        const auto nextLines = sfun::after(testCfg.description, "\n");
         const auto descriptionHasMultipleLines = nextLines.has_value() && !nextLines.value().empty();
         if (descriptionHasMultipleLines)
-            print("Description:\n{}", test.description());
+            print("Description:\n{}", testCfg.description);
         else
-            print("Description: {}", test.description());
+            print("Description: {}", testCfg.description);
     }
 
     const auto resultStr = fmt::format("Result: {:>10}", "DISABLED");
     lunchtoast::print(fmt::runtime("{:>" + std::to_string(reportWidth_) + "}"), resultStr);
+    flushReport();
+}
+
+void TestReporter::reportStoppedTesting(int maxFailedTests) const
+{
+    printNewLine();
+    print(
+            TestResultType::Failure,
+            "Testing was stopped: the maximum number of failed tests ({}) has been reached",
+            maxFailedTests);
+}
+
+void TestReporter::reportCollectedFailedTests(std::uintmax_t bytesCopied) const
+{
+    printNewLine();
+    print("Failed tests were collected: {} bytes copied", bytesCopied);
+}
+
+void TestReporter::reportWatchingFiles() const
+{
+    printNewLine();
+    print("Watching for changes of test files. Press Ctrl+C to stop.");
+    flushReport();
+}
+
+void TestReporter::reportChangedFiles(const std::set<fs::path>& changedFiles) const
+{
+    const auto toPathString = [](const fs::path& path)
+    {
+        return homePathString(path);
+    };
+    const auto changedFileList = changedFiles | views::transform(toPathString) | ranges::to<std::vector>;
+    print("Changed files: {}", sfun::join(changedFileList, ", "));
+    printNewLine();
 }
 
 namespace {
-std::tuple<int, int, int> countTotals(const TestSuite& defaultSuite, const std::map<std::string, TestSuite>& suites)
+std::tuple<int, int, int, int> countTotals(
+        const TestSuite& defaultSuite,
+        const std::map<std::string, TestSuite>& suites)
 {
     auto totalTests = std::ssize(defaultSuite.tests);
     auto totalPassed = defaultSuite.passedTestsCounter;
     auto totalDisabled = defaultSuite.disabledTestsCounter;
+    auto totalSkipped = defaultSuite.skippedTestsCounter;
     for (const auto& suite : suites | views::values) {
         totalTests += std::ssize(suite.tests);
         totalPassed += suite.passedTestsCounter;
         totalDisabled += suite.disabledTestsCounter;
+        totalSkipped += suite.skippedTestsCounter;
     }
-    return std::make_tuple(static_cast<int>(totalTests), totalPassed, totalDisabled);
+    return std::make_tuple(static_cast<int>(totalTests), totalPassed, totalDisabled, totalSkipped);
 }
 
 void reportSuiteResult(
@@ -199,24 +407,20 @@ void reportSuiteResult(
         int passedNumber,
         sfun::ssize_t totalNumber,
         int disabledNumber,
+        int skippedNumber,
         int reportWidth)
 {
     if (totalNumber == 0 && disabledNumber == 0)
         return;
-    const auto failedNumber = totalNumber - disabledNumber - passedNumber;
+    const auto failedNumber = totalNumber - disabledNumber - skippedNumber - passedNumber;
     const auto width = reportWidth / 2 + 4;
     suiteName = truncateString(suiteName, width - 1) + ":";
     const auto resultType = failedNumber ? TestResultType::Failure : TestResultType::Success;
-    auto resultStr = std::string{};
+    auto resultStr = fmt::format("{} out of {} passed, {} failed", passedNumber, totalNumber, failedNumber);
     if (disabledNumber)
-        resultStr = fmt::format(
-                "{} out of {} passed, {} failed, {} disabled",
-                passedNumber,
-                totalNumber,
-                failedNumber,
-                disabledNumber);
-    else
-        resultStr = fmt::format("{} out of {} passed, {} failed", passedNumber, totalNumber, failedNumber);
+        resultStr += fmt::format(", {} disabled", disabledNumber);
+    if (skippedNumber)
+        resultStr += fmt::format(", {} skipped", skippedNumber);
     print(resultType, fmt::runtime("{:" + std::to_string(width) + "} {}"), suiteName, resultStr);
 }
 
@@ -224,7 +428,10 @@ void reportSuiteResult(
 
 void TestReporter::reportSummary(const TestSuite& defaultSuite, const std::map<std::string, TestSuite>& suites) const
 {
-    auto [totalTests, totalPassed, totalDisabled] = countTotals(defaultSuite, suites);
+    if (progressDisplay_)
+        progressDisplay_->stop();
+
+    auto [totalTests, totalPassed, totalDisabled, totalSkipped] = countTotals(defaultSuite, suites);
     if (totalTests == 0 && totalDisabled == 0) {
         print("No tests were found. Exiting.");
         return;
@@ -238,6 +445,7 @@ void TestReporter::reportSummary(const TestSuite& defaultSuite, const std::map<s
             defaultSuite.passedTestsCounter,
             std::ssize(defaultSuite.tests),
             defaultSuite.disabledTestsCounter,
+            defaultSuite.skippedTestsCounter,
             reportWidth_);
     for (const auto& [suiteName, suite] : suites) {
         reportSuiteResult(
@@ -245,10 +453,11 @@ void TestReporter::reportSummary(const TestSuite& defaultSuite, const std::map<s
                 suite.passedTestsCounter,
                 std::ssize(suite.tests),
                 suite.disabledTestsCounter,
+                suite.skippedTestsCounter,
                 reportWidth_);
     }
     print("---");
-    reportSuiteResult("Total", totalPassed, totalTests, totalDisabled, reportWidth_);
+    reportSuiteResult("Total", totalPassed, totalTests, totalDisabled, totalSkipped, reportWidth_);
 }
 
 } //namespace lunchtoast
\ No newline at end of file
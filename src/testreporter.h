@@ -1,24 +1,44 @@
 #pragma once
+#include "testresult.h"
 #include "testsuite.h"
 #include <sfun/utility.h>
+#include <chrono>
+#include <cstdint>
 #include <filesystem>
+#include <functional>
 #include <map>
+#include <memory>
+#include <optional>
+#include <set>
 #include <string>
+#include <string_view>
+#include <vector>
 
 namespace lunchtoast {
 
 class Test;
-class TestResult;
+class ProgressDisplay;
 
 class TestReporter {
 public:
-    TestReporter(const std::filesystem::path& reportFilePath, int reportWidth);
+    // The synchronous reporter writes each report line before returning, so the report isn't lost on interruption
+    TestReporter(const std::filesystem::path& reportFilePath, int reportWidth, bool showProgress, bool isSynchronous);
+    // Report lines are passed to the output handler instead of the console
+    TestReporter(std::function<void(std::string_view)> outputHandler, int reportWidth);
+    ~TestReporter();
+    TestReporter(const TestReporter&) = delete;
+    TestReporter& operator=(const TestReporter&) = delete;
+    void reportTestingStarted(
+            std::map<std::string, std::optional<std::chrono::milliseconds>> expectedTestDurations) const;
+    void reportTestStarted(const std::string& testName) const;
+    void reportTestFinished(const std::string& testName, bool isFailed) const;
     void reportResult(
             const Test& test,
             const TestResult& result,
             std::string suiteName,
             int suiteTestNumber,
-            sfun::ssize_t suiteNumOfTests) const;
+            sfun::ssize_t suiteNumOfTests,
+            const std::optional<TestIterationsStats>& iterationsStats = std::nullopt) const;
     void reportBrokenTest(
             const std::filesystem::path& brokenTestConfig,
             const std::string& errorInfo,
@@ -26,14 +46,19 @@ public:
             int suiteTestNumber,
             sfun::ssize_t suiteNumOfTests) const;
     void reportDisabledTest( //
-            const Test& test,
+            const TestCfg& testCfg,
             std::string suiteName,
             int suiteTestNumber,
             sfun::ssize_t suiteNumOfTests) const;
+    void reportStoppedTesting(int maxFailedTests) const;
+    void reportCollectedFailedTests(std::uintmax_t bytesCopied) const;
+    void reportWatchingFiles() const;
+    void reportChangedFiles(const std::set<std::filesystem::path>& changedFiles) const;
     void reportSummary(const TestSuite& defaultSuite, const std::map<std::string, TestSuite>& suites) const;
 
 private:
     int reportWidth_;
+    std::unique_ptr<ProgressDisplay> progressDisplay_;
 };
 
 } //namespace lunchtoast
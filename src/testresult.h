@@ -1,4 +1,5 @@
 #pragma once
+#include <chrono>
 #include <string>
 #include <vector>
 
@@ -10,6 +11,14 @@ enum class TestResultType {
     RuntimeError
 };
 
+struct TestIterationsStats {
+    int iterationsCount;
+    int passedIterationsCount;
+    std::chrono::milliseconds minDuration;
+    std::chrono::milliseconds medianDuration;
+    std::chrono::milliseconds maxDuration;
+};
+
 class TestResult {
 public:
     static TestResult Success();
@@ -1,6 +1,7 @@
 #pragma once
-#include "useraction.h"
+#include "useractionlist.h"
 #include <filesystem>
+#include <memory>
 #include <set>
 #include <string>
 #include <unordered_map>
@@ -12,13 +13,21 @@ struct TestCfg {
     std::filesystem::path path;
     bool isEnabled;
     std::unordered_map<std::string, std::string> vars;
-    std::vector<UserAction> userActions;
+    std::shared_ptr<const UserActionList> userActions;
+    std::vector<std::filesystem::path> configList;
+    std::set<std::string> tags;
+    std::set<std::string> resources;
+    // Disabled tests are reported with the name and description read during the tests collection,
+    // without creating a Test object which reads the whole test case and the test directory contents
+    std::string name;
+    std::string description;
 };
 
 struct TestSuite {
     std::vector<TestCfg> tests;
     int passedTestsCounter = 0;
     int disabledTestsCounter = 0;
+    int skippedTestsCounter = 0;
 };
 
 } //namespace lunchtoast
\ No newline at end of file
@@ -0,0 +1,275 @@
+#include "textdiff.h"
+#include "constants.h"
+#include "utils.h"
+#include <fmt/format.h>
+#include <algorithm>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace lunchtoast {
+
+namespace {
+enum class EditType : char {
+    Equal,
+    Delete,
+    Insert
+};
+
+std::vector<std::string_view> splitLines(std::string_view text)
+{
+    auto result = std::vector<std::string_view>{};
+    if (text.empty())
+        return result;
+    auto pos = std::size_t{0};
+    while (true) {
+        const auto endPos = text.find('\n', pos);
+        if (endPos == std::string_view::npos) {
+            result.push_back(text.substr(pos));
+            return result;
+        }
+        result.push_back(text.substr(pos, endPos - pos));
+        pos = endPos + 1;
+        if (pos == text.size())
+            return result;
+    }
+}
+
+// Lines are replaced with integer identifiers, so the diff algorithm compares numbers instead of strings
+std::pair<std::vector<int>, std::vector<int>> makeLineIds(
+        const std::vector<std::string_view>& lhsLines,
+        const std::vector<std::string_view>& rhsLines)
+{
+    auto lineIds = std::unordered_map<std::string_view, int>{};
+    const auto toIds = [&](const std::vector<std::string_view>& lines)
+    {
+        auto result = std::vector<int>{};
+        result.reserve(lines.size());
+        for (const auto& line : lines)
+            result.push_back(lineIds.emplace(line, static_cast<int>(lineIds.size())).first->second);
+        return result;
+    };
+    auto lhsIds = toIds(lhsLines);
+    auto rhsIds = toIds(rhsLines);
+    return {std::move(lhsIds), std::move(rhsIds)};
+}
+
+// Myers' O((N+M)D) algorithm, returns std::nullopt when the diff exceeds the specified limits
+std::optional<std::vector<EditType>> findShortestEditScript(
+        const std::vector<int>& lhs,
+        const std::vector<int>& rhs,
+        const TextDiffLimits& limits)
+{
+    const auto lhsSize = std::ssize(lhs);
+    const auto rhsSize = std::ssize(rhs);
+    const auto maxDistance = std::min<std::ptrdiff_t>(lhsSize + rhsSize, limits.maxChangedLines);
+    const auto offset = maxDistance + 1;
+    auto v = std::vector<std::ptrdiff_t>(static_cast<std::size_t>(2 * offset + 1));
+    auto trace = std::vector<std::vector<std::ptrdiff_t>>{};
+    auto comparisons = std::int64_t{0};
+
+    auto distance = std::optional<std::ptrdiff_t>{};
+    for (auto d = std::ptrdiff_t{0}; d <= maxDistance && !distance.has_value(); ++d) {
+        for (auto k = -d; k <= d; k += 2) {
+            auto x = (k == -d || (k != d && v[offset + k - 1] < v[offset + k + 1])) ? v[offset + k + 1]
+                                                                                    : v[offset + k - 1] + 1;
+            auto y = x - k;
+            while (x < lhsSize && y < rhsSize && lhs[x] == rhs[y]) {
+                ++x;
+                ++y;
+                ++comparisons;
+            }
+            v[offset + k] = x;
+            if (x >= lhsSize && y >= rhsSize) {
+                distance = d;
+                break;
+            }
+        }
+        trace.emplace_back(v.begin() + (offset - d), v.begin() + (offset + d + 1));
+        comparisons += d + 1;
+        if (comparisons > limits.maxLineComparisons)
+            return std::nullopt;
+    }
+    if (!distance.has_value())
+        return std::nullopt;
+
+    auto result = std::vector<EditType>{};
+    auto x = lhsSize;
+    auto y = rhsSize;
+    for (auto d = distance.value(); d > 0; --d) {
+        const auto& prevV = trace[static_cast<std::size_t>(d - 1)];
+        const auto prevValue = [&](std::ptrdiff_t k)
+        {
+            return prevV[static_cast<std::size_t>(k + d - 1)];
+        };
+        const auto k = x - y;
+        const auto prevK = (k == -d || (k != d && prevValue(k - 1) < prevValue(k + 1))) ? k + 1 : k - 1;
+        const auto prevX = prevValue(prevK);
+        const auto prevY = prevX - prevK;
+        for (; x > prevX && y > prevY; --x, --y)
+            result.push_back(EditType::Equal);
+        if (x == prevX)
+            result.push_back(EditType::Insert);
+        else
+            result.push_back(EditType::Delete);
+        x = prevX;
+        y = prevY;
+    }
+    for (; x > 0; --x)
+        result.push_back(EditType::Equal);
+    std::ranges::reverse(result);
+    return result;
+}
+
+struct Hunk {
+    std::size_t begin;
+    std::size_t end;
+};
+
+std::vector<Hunk> findHunks(const std::vector<EditType>& editScript, std::size_t contextSize)
+{
+    auto result = std::vector<Hunk>{};
+    for (auto i = std::size_t{0}; i < editScript.size(); ++i) {
+        if (editScript[i] == EditType::Equal)
+            continue;
+        const auto begin = i > contextSize ? i - contextSize : 0;
+        auto lastChange = i;
+        for (; i < editScript.size(); ++i) {
+            if (editScript[i] != EditType::Equal)
+                lastChange = i;
+            else if (i - lastChange > 2 * contextSize)
+                break;
+        }
+        const auto end = std::min(editScript.size(), lastChange + 1 + contextSize);
+        result.push_back({begin, end});
+        i = end;
+    }
+    return result;
+}
+
+std::string hunkRange(std::size_t start, std::size_t size)
+{
+    if (size == 1)
+        return fmt::format("{}", start + 1);
+    return fmt::format("{},{}", size ? start + 1 : start, size);
+}
+
+std::string makeFirstDifferenceReport(
+        const std::vector<std::string_view>& expectedLines,
+        const std::vector<std::string_view>& actualLines,
+        std::size_t lineIndex)
+{
+    auto result = fmt::format(
+            "Texts are too different to build a diff, the first difference is at line {}:\n",
+            lineIndex + 1);
+    if (lineIndex < expectedLines.size())
+        result += fmt::format("-{}\n", expectedLines[lineIndex]);
+    if (lineIndex < actualLines.size())
+        result += fmt::format("+{}\n", actualLines[lineIndex]);
+    return result;
+}
+
+} //namespace
+
+std::string makeUnifiedDiff(
+        std::string_view expectedText,
+        std::string_view actualText,
+        int contextSize,
+        const TextDiffLimits& limits)
+{
+    const auto expectedLines = splitLines(expectedText);
+    const auto actualLines = splitLines(actualText);
+    const auto [expectedLineIds, actualLineIds] = makeLineIds(expectedLines, actualLines);
+
+    // Common lines at the beginning and the end of texts are matched before running the diff algorithm
+    const auto [expectedMismatch, actualMismatch] = std::ranges::mismatch(expectedLineIds, actualLineIds);
+    const auto prefixSize = static_cast<std::size_t>(std::distance(expectedLineIds.begin(), expectedMismatch));
+    if (prefixSize == expectedLineIds.size() && prefixSize == actualLineIds.size())
+        return {};
+    const auto maxSuffixSize = std::min(expectedLineIds.size(), actualLineIds.size()) - prefixSize;
+    auto suffixSize = std::size_t{0};
+    while (suffixSize < maxSuffixSize &&
+           expectedLineIds[expectedLineIds.size() - suffixSize - 1] ==
+                   actualLineIds[actualLineIds.size() - suffixSize - 1])
+        ++suffixSize;
+
+    const auto middleEditScript = findShortestEditScript(
+            {expectedLineIds.begin() + prefixSize, expectedLineIds.end() - suffixSize},
+            {actualLineIds.begin() + prefixSize, actualLineIds.end() - suffixSize},
+            limits);
+    if (!middleEditScript.has_value())
+        return makeFirstDifferenceReport(expectedLines, actualLines, prefixSize);
+
+    auto editScript = std::vector<EditType>(prefixSize, EditType::Equal);
+    editScript.insert(editScript.end(), middleEditScript->begin(), middleEditScript->end());
+    editScript.insert(editScript.end(), suffixSize, EditType::Equal);
+
+    auto result = std::string{"--- expected\n+++ actual\n"};
+    auto expectedPos = std::size_t{0};
+    auto actualPos = std::size_t{0};
+    auto editIndex = std::size_t{0};
+    const auto advance = [&](EditType editType)
+    {
+        if (editType != EditType::Insert)
+            ++expectedPos;
+        if (editType != EditType::Delete)
+            ++actualPos;
+    };
+    for (const auto& hunk : findHunks(editScript, static_cast<std::size_t>(contextSize))) {
+        for (; editIndex < hunk.begin; ++editIndex)
+            advance(editScript[editIndex]);
+
+        const auto hunkEdits = std::span{editScript}.subspan(hunk.begin, hunk.end - hunk.begin);
+        const auto expectedSize = static_cast<std::size_t>(std::ranges::count_if(
+                hunkEdits,
+                [](EditType editType)
+                {
+                    return editType != EditType::Insert;
+                }));
+        const auto actualSize = static_cast<std::size_t>(std::ranges::count_if(
+                hunkEdits,
+                [](EditType editType)
+                {
+                    return editType != EditType::Delete;
+                }));
+        result += fmt::format(
+                "@@ -{} +{} @@\n",
+                hunkRange(expectedPos, expectedSize),
+                hunkRange(actualPos, actualSize));
+
+        for (; editIndex < hunk.end; ++editIndex) {
+            const auto editType = editScript[editIndex];
+            if (editType == EditType::Equal)
+                result += fmt::format(" {}\n", expectedLines[expectedPos]);
+            else if (editType == EditType::Delete)
+                result += fmt::format("-{}\n", expectedLines[expectedPos]);
+            else
+                result += fmt::format("+{}\n", actualLines[actualPos]);
+            advance(editType);
+        }
+    }
+    return result;
+}
+
+std::string makeTextMismatchReport(std::string_view textName, std::string_view text, std::string_view expectedText)
+{
+    const auto textSection = [](std::string_view name, std::string_view sectionText)
+    {
+        if (std::ssize(sectionText) > hardcoded::failureReportMaxTextSize)
+            return fmt::format("-{}: {} bytes, omitted\n", name, std::ssize(sectionText));
+        return fmt::format("-{}:\n{}---\n", name, sectionText.empty() ? "" : std::string{sectionText} + "\n");
+    };
+    const auto diff = [&]() -> std::string
+    {
+        auto result = makeUnifiedDiff(expectedText, text);
+        if (result.empty() && text != expectedText)
+            return "Texts differ only by line breaks at the end\n";
+        return result;
+    }();
+    return textSection(textName, text) + //
+            textSection("Expected " + toLower(textName), expectedText) + //
+            fmt::format("-{} diff:\n{}---\n", textName, diff);
+}
+
+} //namespace lunchtoast
@@ -0,0 +1,20 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace lunchtoast {
+
+struct TextDiffLimits {
+    int maxChangedLines = 1000;
+    std::int64_t maxLineComparisons = 100'000'000;
+};
+
+std::string makeUnifiedDiff(
+        std::string_view expectedText,
+        std::string_view actualText,
+        int contextSize = 3,
+        const TextDiffLimits& limits = {});
+std::string makeTextMismatchReport(std::string_view textName, std::string_view text, std::string_view expectedText);
+
+} //namespace lunchtoast
@@ -15,8 +15,9 @@ UserAction::UserAction(const Action& action)
     : commandFormat_{action.command}
     , actionType_{action.stopOnFailure ? TestActionType::Assertion : TestActionType::Expectation}
 {
-    auto [formatRegexStr, paramsOrder] = makeUserActionFormat(action.format);
+    auto [formatRegexStr, paramsOrder, literalPrefix] = makeUserActionFormat(action.format);
     format_ = std::regex{formatRegexStr};
+    formatPrefix_ = std::move(literalPrefix);
     paramsOrder_ = std::move(paramsOrder);
     if (action.checkExitCode.value.has_value())
         processResultCheckModeSet_.emplace(ProcessResultCheckMode::ExitCode{action.checkExitCode.value});
@@ -24,6 +25,15 @@ UserAction::UserAction(const Action& action)
         processResultCheckModeSet_.emplace(ProcessResultCheckMode::Output{action.checkOutput.value()});
     if (action.checkErrorOutput.has_value())
         processResultCheckModeSet_.emplace(ProcessResultCheckMode::ErrorOutput{action.checkErrorOutput.value()});
+
+    const auto limits = std::vector<std::pair<std::string, const figcone::optional<std::string>&>>{
+            {"memory", action.limitMemory},
+            {"CPU time", action.limitCpuTime},
+            {"open files", action.limitOpenFiles},
+            {"processes", action.limitProcesses}};
+    for (const auto& [limitName, limitValue] : limits)
+        if (limitValue.has_value())
+            processLimits_.emplace_back(limitName, limitValue.value());
 }
 
 std::optional<std::string> UserAction::makeCommand(
@@ -55,6 +65,9 @@ std::set<ProcessResultCheckMode> UserAction::makeProcessResultCheckModeSet(
 {
     const auto checkModeVisitor = sfun::overloaded{
             [](ProcessResultCheckMode::ExitCode&) {},
+            [](ProcessResultCheckMode::MaxMemory&) {},
+            [](ProcessResultCheckMode::MaxDuration&) {},
+            [](ProcessResultCheckMode::PerformanceBaseline&) {},
             [&](auto& checkMode)
             {
                 for (const auto& [name, value] : readInputParamSections(inputParam))
@@ -70,9 +83,22 @@ std::set<ProcessResultCheckMode> UserAction::makeProcessResultCheckModeSet(
     return processResultCheckModeSet_ | views::transform(processCheckMode) | ranges::to<std::set>;
 }
 
+ProcessLimits UserAction::makeProcessLimits(const std::unordered_map<std::string, std::string>& vars) const
+{
+    auto result = ProcessLimits{};
+    for (const auto& [limitName, limitValue] : processLimits_)
+        readProcessLimit(result, limitName, processVariablesSubstitution(limitValue, vars));
+    return result;
+}
+
 TestActionType UserAction::actionType() const
 {
     return actionType_;
 }
 
+const std::string& UserAction::formatPrefix() const
+{
+    return formatPrefix_;
+}
+
 } //namespace lunchtoast
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 #include "config.h"
+#include "processlimits.h"
 #include "processresultcheckmode.h"
 #include "testactiontype.h"
 #include <filesystem>
@@ -21,13 +22,18 @@ public:
     std::set<ProcessResultCheckMode> makeProcessResultCheckModeSet(
             const std::unordered_map<std::string, std::string>& vars,
             const std::string& inputParam) const;
+    ProcessLimits makeProcessLimits(const std::unordered_map<std::string, std::string>& vars) const;
     TestActionType actionType() const;
+    const std::string& formatPrefix() const;
 
 private:
     std::regex format_;
+    std::string formatPrefix_;
     std::string commandFormat_;
     std::vector<int> paramsOrder_;
     std::set<ProcessResultCheckMode> processResultCheckModeSet_;
+    // Limits are read when the action is used, as their values can contain variables
+    std::vector<std::pair<std::string, std::string>> processLimits_;
     TestActionType actionType_;
 };
 
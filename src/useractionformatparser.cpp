@@ -12,9 +12,11 @@
 #include <set>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <variant>
 
 namespace lunchtoast {
+using namespace std::string_view_literals;
 
 struct StringToken {
     std::string value;
@@ -87,6 +89,28 @@ void validateUserActionFormat(std::string_view formatString, const UserActionFor
         throw formatParamsError();
 }
 
+std::string makeLiteralPrefix(const std::vector<Token>& tokens, const std::string& formatRegex)
+{
+    // String tokens are used in the format regex as is, so a top level alternation
+    // or a quantifier can make their characters optional
+    if (tokens.empty() || !std::holds_alternative<StringToken>(tokens.front()) ||
+        formatRegex.find('|') != std::string::npos)
+        return {};
+
+    static constexpr auto regexSpecialChars = R"(\^$.|?*+()[]{})"sv;
+    static constexpr auto regexQuantifierChars = "?*+{"sv;
+    auto result = std::string{};
+    for (auto ch : std::get<StringToken>(tokens.front()).value) {
+        if (regexSpecialChars.find(ch) != std::string_view::npos) {
+            if (regexQuantifierChars.find(ch) != std::string_view::npos && !result.empty())
+                result.pop_back();
+            break;
+        }
+        result.push_back(ch);
+    }
+    return result;
+}
+
 } //namespace
 
 UserActionFormat makeUserActionFormat(const std::string& format)
@@ -121,6 +145,7 @@ UserActionFormat makeUserActionFormat(const std::string& format)
     }
 
     validateUserActionFormat(format, result);
+    result.literalPrefix = makeLiteralPrefix(tokens, result.formatRegex);
     return result;
 }
 
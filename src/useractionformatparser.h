@@ -8,6 +8,7 @@ namespace lunchtoast {
 struct UserActionFormat {
     std::string formatRegex;
     std::vector<int> paramsOrder;
+    std::string literalPrefix;
 };
 UserActionFormat makeUserActionFormat(const std::string& format);
 
@@ -0,0 +1,48 @@
+#include "useractionlist.h"
+#include <algorithm>
+
+namespace lunchtoast {
+
+UserActionList::UserActionList(std::vector<UserAction> actions)
+    : actions_{std::move(actions)}
+{
+    for (auto actionIndex = std::size_t{0}; actionIndex < actions_.size(); ++actionIndex) {
+        auto nodeIndex = std::size_t{0};
+        for (auto ch : actions_[actionIndex].formatPrefix()) {
+            auto it = prefixTree_[nodeIndex].children.find(ch);
+            if (it == prefixTree_[nodeIndex].children.end()) {
+                prefixTree_[nodeIndex].children.emplace(ch, prefixTree_.size());
+                nodeIndex = prefixTree_.size();
+                prefixTree_.emplace_back();
+            }
+            else
+                nodeIndex = it->second;
+        }
+        prefixTree_[nodeIndex].actionIndices.push_back(actionIndex);
+    }
+}
+
+std::vector<std::reference_wrapper<const UserAction>> UserActionList::matchingCandidates(
+        const std::string& actionName) const
+{
+    // Only actions whose format starts with a prefix of the action name can match it,
+    // they're returned in the original order to keep the first matching action winning
+    auto actionIndices = prefixTree_.front().actionIndices;
+    auto nodeIndex = std::size_t{0};
+    for (auto ch : actionName) {
+        const auto it = prefixTree_[nodeIndex].children.find(ch);
+        if (it == prefixTree_[nodeIndex].children.end())
+            break;
+        nodeIndex = it->second;
+        const auto& nodeActionIndices = prefixTree_[nodeIndex].actionIndices;
+        actionIndices.insert(actionIndices.end(), nodeActionIndices.begin(), nodeActionIndices.end());
+    }
+    std::ranges::sort(actionIndices);
+
+    auto result = std::vector<std::reference_wrapper<const UserAction>>{};
+    for (auto actionIndex : actionIndices)
+        result.emplace_back(actions_[actionIndex]);
+    return result;
+}
+
+} //namespace lunchtoast
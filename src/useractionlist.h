@@ -0,0 +1,26 @@
+#pragma once
+#include "useraction.h"
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace lunchtoast {
+
+class UserActionList {
+public:
+    UserActionList() = default;
+    explicit UserActionList(std::vector<UserAction> actions);
+    std::vector<std::reference_wrapper<const UserAction>> matchingCandidates(const std::string& actionName) const;
+
+private:
+    struct PrefixTreeNode {
+        std::map<char, std::size_t> children;
+        std::vector<std::size_t> actionIndices;
+    };
+
+    std::vector<UserAction> actions_;
+    std::vector<PrefixTreeNode> prefixTree_ = {PrefixTreeNode{}};
+};
+
+} //namespace lunchtoast
@@ -9,8 +9,11 @@
 #include <sfun/string_utils.h>
 #include <sfun/utility.h>
 #include <gsl/util>
+#include <array>
 #include <fstream>
+#include <limits>
 #include <optional>
+#include <random>
 #include <regex>
 #include <sstream>
 
@@ -81,21 +84,34 @@ std::string StringStream::readUntil(std::function<bool(char ch)> pred, bool& sto
     return result;
 }
 
-std::string normalizeLineEndings(std::string_view str)
+std::string normalizeLineEndings(std::string str)
 {
-    auto result = sfun::replace(std::string{str}, "\r\n", "\n");
-    return sfun::replace(result, "\r", "\n");
+    // Texts without carriage returns are the common case, so they're detected with a single memchr based scan
+    // and returned without modification; otherwise the line breaks are replaced in place
+    auto readPos = str.find('\r');
+    if (readPos == std::string::npos)
+        return str;
+
+    auto writePos = readPos;
+    while (readPos != std::string::npos) {
+        str[writePos++] = '\n';
+        ++readPos;
+        if (readPos < str.size() && str[readPos] == '\n')
+            ++readPos;
+
+        const auto nextCarriageReturnPos = str.find('\r', readPos);
+        const auto chunkEndPos = nextCarriageReturnPos == std::string::npos ? str.size() : nextCarriageReturnPos;
+        std::copy(str.begin() + readPos, str.begin() + chunkEndPos, str.begin() + writePos);
+        writePos += chunkEndPos - readPos;
+        readPos = nextCarriageReturnPos;
+    }
+    str.resize(writePos);
+    return str;
 }
 
 std::string readTextFile(const fs::path& filePath)
 {
-    auto fileStream = std::ifstream{filePath, std::ios::binary};
-    if (!fileStream.is_open())
-        throw std::runtime_error{fmt::format("Can't open {}", sfun::path_string(filePath))};
-    fileStream.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-    auto buffer = std::stringstream{};
-    buffer << fileStream.rdbuf();
-    return normalizeLineEndings(buffer.str());
+    return normalizeLineEndings(readFile(filePath));
 }
 
 std::string readFile(const fs::path& filePath)
@@ -104,10 +120,19 @@ std::string readFile(const fs::path& filePath)
     if (!fileStream.is_open())
         throw std::runtime_error{fmt::format("Can't open {}", sfun::path_string(filePath))};
 
-    fileStream.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-    auto buffer = std::stringstream{};
-    buffer << fileStream.rdbuf();
-    return buffer.str();
+    fileStream.exceptions(std::ifstream::badbit);
+    // The file size is only a hint, as the file can grow while it's read,
+    // and special files like the ones in /proc report zero size
+    auto result = std::string{};
+    auto errorCode = std::error_code{};
+    const auto fileSize = fs::file_size(filePath, errorCode);
+    if (!errorCode)
+        result.reserve(fileSize);
+
+    auto buffer = std::array<char, 64 * 1024>{};
+    while (fileStream.read(buffer.data(), std::ssize(buffer)) || fileStream.gcount() > 0)
+        result.append(buffer.data(), static_cast<std::size_t>(fileStream.gcount()));
+    return result;
 }
 
 std::vector<std::string> splitSectionValue(const std::string& input)
@@ -120,6 +145,18 @@ std::vector<std::string> splitSectionValue(const std::string& input)
     return result;
 }
 
+std::vector<std::string> readTabSeparatedFields(const std::string& line)
+{
+    auto result = std::vector<std::string>{};
+    auto stream = std::istringstream{line};
+    auto field = std::string{};
+    while (std::getline(stream, field, '\t'))
+        result.emplace_back(std::move(field));
+    if (!line.empty() && line.back() == '\t')
+        result.emplace_back();
+    return result;
+}
+
 std::vector<fs::path> readFilenames(const std::string& input, const fs::path& directory)
 {
     const auto makePath = [&](const std::string& fileName)
@@ -155,6 +192,31 @@ std::vector<fs::path> getDirectoryContent(const fs::path& dir)
     return result;
 }
 
+void writePathList(const std::vector<fs::path>& pathList, const fs::path& outputFile)
+{
+    if (pathList.empty())
+        return;
+
+    auto stream = std::ofstream{outputFile};
+    for (const auto& path : pathList)
+        stream << sfun::replace(sfun::path_string(path.parent_path()), "\\", "/") << std::endl;
+}
+
+void writeFileAtomically(const fs::path& filePath, const std::function<void(std::ostream&)>& writeContent)
+{
+    auto random = std::random_device{};
+    const auto tempFilePath = fs::path{filePath}.concat(fmt::format(".{:x}.tmp", random()));
+    auto stream = std::ofstream{tempFilePath};
+    writeContent(stream);
+    stream.close();
+    if (!stream) {
+        auto error = std::error_code{};
+        fs::remove(tempFilePath, error);
+        throw std::runtime_error{fmt::format("Can't write {}", sfun::path_string(filePath))};
+    }
+    fs::rename(tempFilePath, filePath);
+}
+
 namespace {
 std::filesystem::path homePath()
 {
@@ -212,6 +274,32 @@ std::vector<std::string> splitCommand(const std::string& str)
     return result;
 }
 
+std::vector<std::string> splitPipeline(const std::string& str)
+{
+    auto result = std::vector<std::string>{};
+    auto stage = std::string{};
+    auto quotationMark = std::optional<char>{};
+    for (const auto ch : str) {
+        if (quotationMark.has_value()) {
+            if (ch == quotationMark.value())
+                quotationMark = std::nullopt;
+        }
+        else if (ch == '\"' || ch == '\'' || ch == '`')
+            quotationMark = ch;
+        else if (ch == '|') {
+            result.emplace_back(sfun::trim(stage));
+            stage.clear();
+            continue;
+        }
+        stage += ch;
+    }
+    if (quotationMark.has_value())
+        throw TestConfigError{fmt::format("Pipeline '{}' has an unclosed quotation mark", str)};
+
+    result.emplace_back(sfun::trim(stage));
+    return result;
+}
+
 std::unordered_map<std::string, std::string> readInputParamSections(const std::string& inputParam)
 {
     auto inputStringStream = std::stringstream{inputParam};
@@ -263,7 +351,13 @@ std::optional<std::chrono::milliseconds> readTime(std::string_view str)
     auto match = std::smatch{};
     if (!std::regex_match(timePeriod, match, format))
         return std::nullopt;
-    const auto timeValue = std::stoi(match[1].str());
+    auto timeValue = 0;
+    try {
+        timeValue = std::stoi(match[1].str());
+    }
+    catch (const std::out_of_range&) {
+        return std::nullopt;
+    }
 
     if (match.size() > 2 && match[2].length() > 0){
         const auto timeFormat = match[2].str();
@@ -282,4 +376,38 @@ std::optional<std::chrono::milliseconds> readTime(std::string_view str)
     else return std::nullopt;
 }
 
+std::optional<std::int64_t> readDataSize(std::string_view str)
+{
+    static const auto format = std::regex{R"((\d+)\s*([a-zA-Z]*))"};
+    static const auto units = std::vector<std::pair<std::string_view, std::int64_t>>{
+            {""sv, 1},
+            {"b"sv, 1},
+            {"bytes"sv, 1},
+            {"k"sv, 1024},
+            {"kb"sv, 1024},
+            {"m"sv, 1024 * 1024},
+            {"mb"sv, 1024 * 1024},
+            {"g"sv, 1024 * 1024 * 1024},
+            {"gb"sv, 1024 * 1024 * 1024}};
+
+    auto match = std::cmatch{};
+    const auto sizeStr = sfun::trim(str);
+    if (!std::regex_match(sizeStr.data(), sizeStr.data() + sizeStr.size(), match, format))
+        return std::nullopt;
+
+    const auto unit = toLower(match[2].str());
+    const auto unitIt = std::ranges::find(units, unit, &std::pair<std::string_view, std::int64_t>::first);
+    if (unitIt == units.end())
+        return std::nullopt;
+    try {
+        const auto size = std::stoll(match[1].str());
+        if (size > std::numeric_limits<std::int64_t>::max() / unitIt->second)
+            return std::nullopt;
+        return size * unitIt->second;
+    }
+    catch (const std::out_of_range&) {
+        return std::nullopt;
+    }
+}
+
 } //namespace lunchtoast
\ No newline at end of file
@@ -9,6 +9,7 @@
 #include <unordered_map>
 #include <vector>
 #include <chrono>
+#include <cstdint>
 
 namespace lunchtoast {
 
@@ -17,13 +18,21 @@ std::string readFile(const std::filesystem::path& filePath);
 std::vector<std::filesystem::path> readFilenames(const std::string& input, const std::filesystem::path& directory);
 std::string processVariablesSubstitution(std::string value, const std::unordered_map<std::string, std::string>& vars);
 std::vector<std::filesystem::path> getDirectoryContent(const std::filesystem::path& dir);
+void writePathList(const std::vector<std::filesystem::path>& pathList, const std::filesystem::path& outputFile);
+// Writes the content to a temporary file and renames it over the output file,
+// so an interrupted or failed write never leaves a partially written file
+void writeFileAtomically(const std::filesystem::path& filePath, const std::function<void(std::ostream&)>& writeContent);
 std::string homePathString(const std::filesystem::path& path);
 std::string toLower(std::string_view str);
 std::vector<std::string> splitCommand(const std::string& str);
+// Splits the command line of a pipeline by the '|' characters outside the quotation marks
+std::vector<std::string> splitPipeline(const std::string& str);
 std::vector<std::string> splitSectionValue(const std::string& str);
+std::vector<std::string> readTabSeparatedFields(const std::string& line);
 std::unordered_map<std::string, std::string> readInputParamSections(const std::string&);
-std::string normalizeLineEndings(std::string_view str);
+std::string normalizeLineEndings(std::string str);
 std::optional<std::chrono::milliseconds> readTime(std::string_view str);
+std::optional<std::int64_t> readDataSize(std::string_view str);
 
 
 template<typename TContainer>
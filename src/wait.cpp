@@ -5,24 +5,29 @@
 
 namespace lunchtoast {
 
-Wait::Wait(std::chrono::milliseconds timePeriod)
+Wait::Wait(std::chrono::milliseconds timePeriod, sfun::optional_ref<TestCancellation> cancellation)
     : timePeriod_{timePeriod}
+    , cancellation_{cancellation}
 {
 }
 
 TestActionResult Wait::operator()() const
 {
-    std::this_thread::sleep_for(timePeriod_);
+    // Waiting is interrupted when the testing is stopped
+    if (cancellation_.has_value())
+        cancellation_->waitFor(timePeriod_);
+    else
+        std::this_thread::sleep_for(timePeriod_);
     return TestActionResult::Success();
 }
 
-Wait makeWaitAction(const Section& section)
+Wait makeWaitAction(const Section& section, sfun::optional_ref<TestCancellation> cancellation)
 {
     auto time = readTime(section.value);
     if (!time.has_value())
         throw TestConfigError{"Wait section value must specify time duration (e.g. '500 ms')"};
 
-    return Wait{time.value()};
+    return Wait{time.value(), cancellation};
 }
 
 }//namespace lunchtoast
\ No newline at end of file
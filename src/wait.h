@@ -1,6 +1,8 @@
 #pragma once
 #include "testactionresult.h"
 #include "section.h"
+#include "testcancellation.h"
+#include <sfun/optional_ref.h>
 #include <filesystem>
 #include <string>
 #include <chrono>
@@ -9,13 +11,16 @@ namespace lunchtoast {
 
 class Wait {
 public:
-    explicit Wait(std::chrono::milliseconds timePeriod);
+    explicit Wait(
+            std::chrono::milliseconds timePeriod,
+            sfun::optional_ref<TestCancellation> cancellation = std::nullopt);
     TestActionResult operator()() const;
 
 private:
     std::chrono::milliseconds timePeriod_;
+    sfun::optional_ref<TestCancellation> cancellation_;
 };
 
-Wait makeWaitAction(const Section&);
+Wait makeWaitAction(const Section&, sfun::optional_ref<TestCancellation> cancellation);
 
 } //namespace lunchtoast
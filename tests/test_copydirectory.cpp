@@ -0,0 +1,114 @@
+#include <copydirectory.h>
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+namespace {
+void writeFile(const fs::path& path, const std::string& content)
+{
+    fs::create_directories(path.parent_path());
+    auto stream = std::ofstream{path, std::ios::binary};
+    stream << content;
+}
+
+std::string readFile(const fs::path& path)
+{
+    auto stream = std::ifstream{path, std::ios::binary};
+    auto buffer = std::stringstream{};
+    buffer << stream.rdbuf();
+    return buffer.str();
+}
+
+class CopyDirectory : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        dir_ = fs::temp_directory_path() / "lunchtoast_test_copydirectory";
+        fs::remove_all(dir_);
+        fs::create_directories(dir_);
+    }
+
+    void TearDown() override
+    {
+        auto errorCode = std::error_code{};
+        fs::permissions(dir_ / "source" / "readonly.txt", fs::perms::owner_write, fs::perm_options::add, errorCode);
+        fs::remove_all(dir_);
+    }
+
+    fs::path dir_;
+};
+} //namespace
+
+TEST_F(CopyDirectory, CopyFiles)
+{
+    writeFile(dir_ / "source" / "file.txt", "Hello world");
+    writeFile(dir_ / "source" / "subdir" / "file2.txt", "Hello");
+    fs::create_directories(dir_ / "source" / "empty_subdir");
+
+    const auto bytesCopied = lunchtoast::copyDirectory(dir_ / "source", dir_ / "target");
+    EXPECT_EQ(bytesCopied, 16);
+    EXPECT_EQ(readFile(dir_ / "target" / "file.txt"), "Hello world");
+    EXPECT_EQ(readFile(dir_ / "target" / "subdir" / "file2.txt"), "Hello");
+    EXPECT_TRUE(fs::is_directory(dir_ / "target" / "empty_subdir"));
+}
+
+TEST_F(CopyDirectory, SkipUpToDateFiles)
+{
+    writeFile(dir_ / "source" / "file.txt", "Hello world");
+    EXPECT_EQ(lunchtoast::copyDirectory(dir_ / "source", dir_ / "target"), 11);
+    EXPECT_EQ(lunchtoast::copyDirectory(dir_ / "source", dir_ / "target"), 0);
+}
+
+TEST_F(CopyDirectory, LinkReadOnlyFiles)
+{
+    writeFile(dir_ / "source" / "readonly.txt", "Hello world");
+    fs::permissions(
+            dir_ / "source" / "readonly.txt",
+            fs::perms::owner_write | fs::perms::group_write | fs::perms::others_write,
+            fs::perm_options::remove);
+
+    const auto bytesCopied = lunchtoast::copyDirectory(dir_ / "source", dir_ / "target");
+    EXPECT_EQ(readFile(dir_ / "target" / "readonly.txt"), "Hello world");
+    if (fs::hard_link_count(dir_ / "source" / "readonly.txt") == 2)
+        EXPECT_EQ(bytesCopied, 0);
+    else
+        EXPECT_EQ(bytesCopied, 11);
+}
+
+TEST_F(CopyDirectory, RecreateSymlinks)
+{
+    writeFile(dir_ / "source" / "file.txt", "Hello world");
+    writeFile(dir_ / "outside" / "file.txt", "Hello");
+    fs::create_symlink("file.txt", dir_ / "source" / "file_link.txt");
+    fs::create_directory_symlink(dir_ / "outside", dir_ / "source" / "outside_link");
+    fs::create_directory_symlink("..", dir_ / "source" / "loop_link");
+
+    const auto bytesCopied = lunchtoast::copyDirectory(dir_ / "source", dir_ / "target");
+    EXPECT_EQ(bytesCopied, 11);
+    EXPECT_EQ(fs::read_symlink(dir_ / "target" / "file_link.txt"), "file.txt");
+    EXPECT_EQ(fs::read_symlink(dir_ / "target" / "outside_link"), dir_ / "outside");
+    EXPECT_EQ(fs::read_symlink(dir_ / "target" / "loop_link"), "..");
+    EXPECT_EQ(readFile(dir_ / "target" / "file_link.txt"), "Hello world");
+
+    EXPECT_EQ(lunchtoast::copyDirectory(dir_ / "source", dir_ / "target"), 0);
+    EXPECT_EQ(fs::read_symlink(dir_ / "target" / "file_link.txt"), "file.txt");
+}
+
+TEST_F(CopyDirectory, CopyDirectoriesInParallel)
+{
+    writeFile(dir_ / "source" / "test1" / "file.txt", "Hello");
+    writeFile(dir_ / "source" / "test2" / "file.txt", "world");
+    writeFile(dir_ / "source" / "nested" / "test1" / "file2.txt", "!");
+
+    const auto bytesCopied = lunchtoast::copyDirectories(
+            {{dir_ / "source" / "test1", dir_ / "target" / "test1"},
+             {dir_ / "source" / "test2", dir_ / "target" / "test2"},
+             {dir_ / "source" / "nested" / "test1", dir_ / "target" / "test1"}});
+    EXPECT_EQ(bytesCopied, 11);
+    EXPECT_EQ(readFile(dir_ / "target" / "test1" / "file.txt"), "Hello");
+    EXPECT_EQ(readFile(dir_ / "target" / "test1" / "file2.txt"), "!");
+    EXPECT_EQ(readFile(dir_ / "target" / "test2" / "file.txt"), "world");
+}
@@ -0,0 +1,101 @@
+#include <errors.h>
+#include <generatefile.h>
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+namespace {
+std::string generate(const std::string& specStr)
+{
+    auto stream = std::ostringstream{};
+    lunchtoast::generateData(lunchtoast::readGeneratedDataSpec(specStr), stream);
+    return stream.str();
+}
+
+std::string readFile(const fs::path& path)
+{
+    auto stream = std::ifstream{path, std::ios::binary};
+    auto buffer = std::stringstream{};
+    buffer << stream.rdbuf();
+    return buffer.str();
+}
+} //namespace
+
+TEST(GenerateFile, RandomBytes)
+{
+    const auto data = generate("seed = 42\nrandom bytes = 1 KB\n");
+    EXPECT_EQ(data.size(), 1024);
+    EXPECT_EQ(generate("random bytes = 1 KB\n  seed = 42  \n"), data);
+    EXPECT_NE(generate("seed = 43\nrandom bytes = 1 KB\n"), data);
+    EXPECT_EQ(generate("seed = 42\nrandom bytes = 13\n"), data.substr(0, 13));
+}
+
+TEST(GenerateFile, RepeatedLines)
+{
+    EXPECT_EQ(generate("repeated lines = 3\nline = Hello world"), "Hello world\nHello world\nHello world\n");
+    EXPECT_EQ(generate("repeated lines = 0\nline = Hello world"), "");
+}
+
+TEST(GenerateFile, CsvRows)
+{
+    const auto data = generate("CSV rows = 2\ncolumns = id, value");
+    auto stream = std::istringstream{data};
+    auto row = std::string{};
+    auto rows = std::vector<std::string>{};
+    while (std::getline(stream, row))
+        rows.push_back(row);
+    ASSERT_EQ(rows.size(), 3);
+    EXPECT_EQ(rows[0], "id,value");
+    EXPECT_NE(rows[1].find(','), std::string::npos);
+    EXPECT_EQ(generate("CSV rows = 2\ncolumns = id, value\nseed = 0"), data);
+}
+
+TEST(GenerateFile, DataKey)
+{
+    const auto key = lunchtoast::generatedDataKey(lunchtoast::readGeneratedDataSpec("random bytes = 1 MB"));
+    EXPECT_EQ(key.size(), 16);
+    EXPECT_EQ(lunchtoast::generatedDataKey(lunchtoast::readGeneratedDataSpec("random bytes = 1024 KB")), key);
+    EXPECT_NE(lunchtoast::generatedDataKey(lunchtoast::readGeneratedDataSpec("random bytes = 1 MB\nseed = 1")), key);
+    EXPECT_NE(
+            lunchtoast::generatedDataKey(lunchtoast::readGeneratedDataSpec("repeated lines = 1\nline = a")),
+            lunchtoast::generatedDataKey(lunchtoast::readGeneratedDataSpec("repeated lines = 1\nline = b")));
+}
+
+TEST(GenerateFile, InvalidSpec)
+{
+    EXPECT_THROW(lunchtoast::readGeneratedDataSpec(""), lunchtoast::TestConfigError);
+    EXPECT_THROW(lunchtoast::readGeneratedDataSpec("random bytes"), lunchtoast::TestConfigError);
+    EXPECT_THROW(lunchtoast::readGeneratedDataSpec("random bytes = a lot"), lunchtoast::TestConfigError);
+    EXPECT_THROW(lunchtoast::readGeneratedDataSpec("random bytes = 1\nCSV rows = 1"), lunchtoast::TestConfigError);
+    EXPECT_THROW(lunchtoast::readGeneratedDataSpec("repeated lines = 10"), lunchtoast::TestConfigError);
+    EXPECT_THROW(lunchtoast::readGeneratedDataSpec("CSV rows = -1\ncolumns = a"), lunchtoast::TestConfigError);
+    EXPECT_THROW(lunchtoast::readGeneratedDataSpec("CSV rows = 1"), lunchtoast::TestConfigError);
+    EXPECT_THROW(lunchtoast::readGeneratedDataSpec("random bytes = 1\ncolor = red"), lunchtoast::TestConfigError);
+}
+
+TEST(GenerateFile, CachedFile)
+{
+    const auto dir = fs::temp_directory_path() / "lunchtoast_test_generatefile";
+    fs::remove_all(dir);
+    fs::create_directories(dir / "test");
+    const auto spec = lunchtoast::readGeneratedDataSpec("repeated lines = 2\nline = Hello world");
+    const auto cacheDir = dir / "cache";
+
+    ASSERT_TRUE(lunchtoast::GenerateFile(dir / "test" / "input.txt", spec, cacheDir)().isSuccessful());
+    EXPECT_EQ(readFile(dir / "test" / "input.txt"), "Hello world\nHello world\n");
+    const auto cachedFilePath = cacheDir / (lunchtoast::generatedDataKey(spec) + ".data");
+    EXPECT_EQ(readFile(cachedFilePath), "Hello world\nHello world\n");
+
+    // The existing cached file is used instead of generating the data again
+    fs::permissions(cachedFilePath, fs::perms::owner_write, fs::perm_options::add);
+    {
+        auto stream = std::ofstream{cachedFilePath, std::ios::binary};
+        stream << "Cached";
+    }
+    ASSERT_TRUE(lunchtoast::GenerateFile(dir / "test" / "input.txt", spec, cacheDir)().isSuccessful());
+    EXPECT_EQ(readFile(dir / "test" / "input.txt"), "Cached");
+    fs::remove_all(dir);
+}
@@ -0,0 +1,111 @@
+#include <outputchecker.h>
+#include <gtest/gtest.h>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace lunchtoast;
+
+namespace {
+OutputChecker checkOutput(
+        OutputCheckType checkType,
+        const std::string& expectedOutput,
+        const std::vector<std::string_view>& chunks,
+        const std::optional<std::string>& ignoredLinesPattern = std::nullopt)
+{
+    auto checker = OutputChecker{checkType, expectedOutput, ignoredLinesPattern};
+    for (const auto& chunk : chunks)
+        checker.write(chunk);
+    checker.close();
+    return checker;
+}
+} //namespace
+
+TEST(OutputChecker, WithoutCheck)
+{
+    auto checker = OutputChecker{};
+    checker.write("Hello\r");
+    checker.write("\nworld\r\n");
+    checker.close();
+    EXPECT_TRUE(checker.isSuccessful());
+    EXPECT_EQ(checker.output(), "Hello\nworld\n");
+}
+
+TEST(OutputChecker, Equal)
+{
+    EXPECT_TRUE(checkOutput(OutputCheckType::Equal, "Hello\nworld\n", {"Hel", "lo\r\nwor", "ld\n"}).isSuccessful());
+    EXPECT_FALSE(checkOutput(OutputCheckType::Equal, "Hello\nworld", {"Hello\nworld\n"}).isSuccessful());
+}
+
+TEST(OutputChecker, EqualIgnoringLines)
+{
+    auto checker = checkOutput(
+            OutputCheckType::Equal,
+            "Hello\nworld\n",
+            {"Hello\nTime: 1", "2 ms\nworld\n"},
+            "Time: .*");
+    EXPECT_TRUE(checker.isSuccessful());
+    EXPECT_EQ(checker.output(), "Hello\nworld\n");
+}
+
+TEST(OutputChecker, Contains)
+{
+    EXPECT_TRUE(checkOutput(OutputCheckType::Contains, "world", {"Hello wo", "r", "ld!"}).isSuccessful());
+    EXPECT_TRUE(checkOutput(OutputCheckType::Contains, "o\nw", {"Hello\r", "\nworld"}).isSuccessful());
+    EXPECT_TRUE(checkOutput(OutputCheckType::Contains, "", {"Hello"}).isSuccessful());
+    EXPECT_FALSE(checkOutput(OutputCheckType::Contains, "moon", {"Hello mo", "rld"}).isSuccessful());
+}
+
+TEST(OutputChecker, ContainsIgnoringLines)
+{
+    EXPECT_TRUE(checkOutput(OutputCheckType::Contains, "a\nc", {"a\nb\nc\n"}, "b").isSuccessful());
+    EXPECT_FALSE(checkOutput(OutputCheckType::Contains, "b", {"a\nb\nc\n"}, "b").isSuccessful());
+}
+
+TEST(OutputChecker, ContainsKeepsOnlyBeginningOfOutput)
+{
+    auto checker = OutputChecker{OutputCheckType::Contains, "end", std::nullopt};
+    const auto chunk = std::string(1024, 'x');
+    for (auto i = 0; i < 1024; ++i)
+        checker.write(chunk);
+    checker.write("end");
+    checker.close();
+    EXPECT_TRUE(checker.isSuccessful());
+    EXPECT_EQ(checker.output().size(), 64 * 1024);
+}
+
+TEST(OutputChecker, MatchesLines)
+{
+    const auto patterns = std::string{"Hello .*\nTime: \\d+ ms"};
+    EXPECT_TRUE(
+            checkOutput(OutputCheckType::MatchesLines, patterns, {"Hello world\nTi", "me: 12 ms\n"}).isSuccessful());
+    EXPECT_FALSE(checkOutput(OutputCheckType::MatchesLines, "Hello .*", {"Hello world\nTime: 1 ms\n"}).isSuccessful());
+    EXPECT_FALSE(checkOutput(OutputCheckType::MatchesLines, patterns, {"Hello world\n"}).isSuccessful());
+    EXPECT_FALSE(checkOutput(OutputCheckType::MatchesLines, "Hello \\d+", {"Hello world\n"}).isSuccessful());
+}
+
+TEST(OutputChecker, MatchesLinesFailureReport)
+{
+    auto checker = checkOutput(OutputCheckType::MatchesLines, "Hello\nworld", {"Hello\nmoon\n"});
+    EXPECT_FALSE(checker.isSuccessful());
+    EXPECT_EQ(
+            checker.makeReport("Output"),
+            "-Output:\n"
+            "Hello\n"
+            "moon\n"
+            "\n"
+            "---\n"
+            "-Expected output line patterns:\n"
+            "Hello\n"
+            "world\n"
+            "---\n"
+            "-Output check failure: the line 2 'moon' doesn't match the pattern 'world'\n");
+}
+
+TEST(OutputChecker, LineSetEqual)
+{
+    EXPECT_TRUE(checkOutput(OutputCheckType::LineSetEqual, "a\nb\nc", {"c\na", "\nb\na\n"}).isSuccessful());
+    EXPECT_FALSE(checkOutput(OutputCheckType::LineSetEqual, "a\nb\nc", {"c\na\n"}).isSuccessful());
+    EXPECT_FALSE(checkOutput(OutputCheckType::LineSetEqual, "a\nb", {"a\nb\nc\n"}).isSuccessful());
+    EXPECT_TRUE(checkOutput(OutputCheckType::LineSetEqual, "a\nb", {"a\nb\nc\n"}, "c").isSuccessful());
+}
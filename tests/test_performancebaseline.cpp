@@ -0,0 +1,56 @@
+#include <performancebaseline.h>
+#include <gtest/gtest.h>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+TEST(PerformanceBaseline, OddNumberOfValues)
+{
+    const auto stats = lunchtoast::calculatePerformanceStats({12, 10, 100, 11, 13});
+    EXPECT_EQ(stats.median, 12);
+    EXPECT_EQ(stats.medianAbsoluteDeviation, 1);
+}
+
+TEST(PerformanceBaseline, EvenNumberOfValues)
+{
+    const auto stats = lunchtoast::calculatePerformanceStats({10, 20, 14, 12});
+    EXPECT_EQ(stats.median, 13);
+    EXPECT_EQ(stats.medianAbsoluteDeviation, 2);
+}
+
+TEST(PerformanceBaseline, SingleValue)
+{
+    const auto stats = lunchtoast::calculatePerformanceStats({42});
+    EXPECT_EQ(stats.median, 42);
+    EXPECT_EQ(stats.medianAbsoluteDeviation, 0);
+}
+
+TEST(PerformanceBaseline, ExceedsBaseline)
+{
+    EXPECT_FALSE(lunchtoast::exceedsPerformanceBaseline({.median = 110}, {.median = 100}, 10));
+    EXPECT_TRUE(lunchtoast::exceedsPerformanceBaseline({.median = 111}, {.median = 100}, 10));
+}
+
+TEST(PerformanceBaseline, ExceedsNoisyBaseline)
+{
+    const auto baseline = lunchtoast::PerformanceStats{.median = 100, .medianAbsoluteDeviation = 10};
+    EXPECT_FALSE(lunchtoast::exceedsPerformanceBaseline({.median = 140}, baseline, 10));
+    EXPECT_TRUE(lunchtoast::exceedsPerformanceBaseline({.median = 141}, baseline, 10));
+}
+
+TEST(PerformanceBaseline, WriteAndRead)
+{
+    const auto filePath = fs::temp_directory_path() / "lunchtoast_test_performance.baseline";
+    lunchtoast::writePerformanceBaseline({.median = 120, .medianAbsoluteDeviation = 5}, filePath);
+    const auto stats = lunchtoast::readPerformanceBaseline(filePath);
+    fs::remove(filePath);
+
+    ASSERT_TRUE(stats.has_value());
+    EXPECT_EQ(stats->median, 120);
+    EXPECT_EQ(stats->medianAbsoluteDeviation, 5);
+}
+
+TEST(PerformanceBaseline, MissingFile)
+{
+    EXPECT_FALSE(lunchtoast::readPerformanceBaseline(fs::temp_directory_path() / "lunchtoast_missing.baseline"));
+}
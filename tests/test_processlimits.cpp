@@ -0,0 +1,61 @@
+#include <errors.h>
+#include <processlimits.h>
+#include <gtest/gtest.h>
+#include <csignal>
+
+TEST(ProcessLimits, ReadLimits)
+{
+    auto limits = lunchtoast::ProcessLimits{};
+    EXPECT_TRUE(lunchtoast::readProcessLimit(limits, "memory", "2 GB"));
+    EXPECT_TRUE(lunchtoast::readProcessLimit(limits, "CPU time", "1500 ms"));
+    EXPECT_TRUE(lunchtoast::readProcessLimit(limits, "open files", "64"));
+    EXPECT_TRUE(lunchtoast::readProcessLimit(limits, "processes", " 32 "));
+    EXPECT_FALSE(lunchtoast::readProcessLimit(limits, "threads", "8"));
+
+    EXPECT_EQ(limits.memory, std::int64_t{2} * 1024 * 1024 * 1024);
+    EXPECT_EQ(limits.cpuTime, std::chrono::seconds{2});
+    EXPECT_EQ(limits.openFiles, 64);
+    EXPECT_EQ(limits.processes, 32);
+    EXPECT_EQ(lunchtoast::processLimitsString(limits), "memory 2 GB, CPU time 2 s, open files 64, processes 32");
+}
+
+TEST(ProcessLimits, ReadInvalidLimits)
+{
+    auto limits = lunchtoast::ProcessLimits{};
+    EXPECT_THROW(lunchtoast::readProcessLimit(limits, "memory", "a lot"), lunchtoast::TestConfigError);
+    EXPECT_THROW(lunchtoast::readProcessLimit(limits, "CPU time", "10"), lunchtoast::TestConfigError);
+    EXPECT_THROW(lunchtoast::readProcessLimit(limits, "open files", "0"), lunchtoast::TestConfigError);
+    EXPECT_THROW(lunchtoast::readProcessLimit(limits, "processes", "8 processes"), lunchtoast::TestConfigError);
+    EXPECT_FALSE(lunchtoast::hasProcessLimits(limits));
+}
+
+TEST(ProcessLimits, ExceededLimit)
+{
+    auto limits = lunchtoast::ProcessLimits{};
+    limits.memory = 512 * 1024 * 1024;
+    limits.cpuTime = std::chrono::seconds{1};
+    auto usage = lunchtoast::ProcessResourceUsage{};
+    EXPECT_EQ(lunchtoast::exceededProcessLimit(limits, SIGXCPU, usage), std::nullopt);
+    EXPECT_EQ(lunchtoast::exceededProcessLimit(limits, SIGKILL, usage), std::nullopt);
+    usage.userCpuTime = std::chrono::milliseconds{600};
+    usage.systemCpuTime = std::chrono::milliseconds{350};
+    EXPECT_EQ(lunchtoast::exceededProcessLimit(limits, SIGXCPU, usage), "CPU time limit 1 s exceeded");
+    usage.userCpuTime = std::chrono::milliseconds{1200};
+    EXPECT_EQ(lunchtoast::exceededProcessLimit(limits, SIGKILL, usage), "CPU time limit 1 s exceeded");
+    EXPECT_EQ(lunchtoast::exceededProcessLimit(limits, SIGTERM, usage), std::nullopt);
+    EXPECT_EQ(lunchtoast::exceededProcessLimit({}, SIGKILL, usage), std::nullopt);
+}
+
+TEST(ProcessLimits, ExceededMemoryLimitOnCrash)
+{
+    auto limits = lunchtoast::ProcessLimits{};
+    limits.memory = 512 * 1024 * 1024;
+    auto usage = lunchtoast::ProcessResourceUsage{};
+    usage.maxResidentSetSize = 100 * 1024 * 1024;
+    EXPECT_EQ(lunchtoast::exceededProcessLimit(limits, SIGSEGV, usage), std::nullopt);
+    EXPECT_EQ(lunchtoast::exceededProcessLimit(limits, SIGABRT, usage), std::nullopt);
+    usage.maxResidentSetSize = 500 * 1024 * 1024;
+    EXPECT_EQ(lunchtoast::exceededProcessLimit(limits, SIGSEGV, usage), "memory limit 512 MB exceeded");
+    EXPECT_EQ(lunchtoast::exceededProcessLimit(limits, SIGABRT, usage), "memory limit 512 MB exceeded");
+    EXPECT_EQ(lunchtoast::exceededProcessLimit(limits, SIGKILL, usage), std::nullopt);
+}
@@ -0,0 +1,56 @@
+#include <progressstatus.h>
+#include <gtest/gtest.h>
+
+using namespace std::chrono_literals;
+using Clock = lunchtoast::ProgressStatus::Clock;
+
+TEST(ProgressStatus, RecordedDurations)
+{
+    const auto startTime = Clock::now();
+    auto status = lunchtoast::ProgressStatus{{{"first", 1000ms}, {"second", 2000ms}, {"third", 3000ms}}};
+    EXPECT_EQ(status.estimatedTimeLeft(startTime), 6000ms);
+
+    status.onTestStarted("first", startTime);
+    EXPECT_EQ(status.estimatedTimeLeft(startTime + 400ms), 5600ms);
+    EXPECT_EQ(status.estimatedTimeLeft(startTime + 1500ms), 5000ms);
+
+    status.onTestFinished("first", false, startTime + 1500ms);
+    status.onTestStarted("second", startTime + 1500ms);
+    EXPECT_EQ(status.estimatedTimeLeft(startTime + 2000ms), 4500ms);
+}
+
+TEST(ProgressStatus, TestsStartedOutOfOrder)
+{
+    const auto startTime = Clock::now();
+    auto status = lunchtoast::ProgressStatus{{{"first", 1000ms}, {"second", 2000ms}, {"third", 3000ms}}};
+    status.onTestStarted("third", startTime);
+    status.onTestStarted("first", startTime);
+    EXPECT_EQ(status.estimatedTimeLeft(startTime + 500ms), 5000ms);
+
+    status.onTestFinished("first", false, startTime + 1000ms);
+    EXPECT_EQ(status.estimatedTimeLeft(startTime + 1000ms), 4000ms);
+
+    status.onTestStarted("second", startTime + 1000ms);
+    EXPECT_EQ(status.estimatedTimeLeft(startTime + 2000ms), 2000ms);
+}
+
+TEST(ProgressStatus, UnknownDurations)
+{
+    const auto startTime = Clock::now();
+    auto status = lunchtoast::ProgressStatus{{{"first", std::nullopt}, {"second", std::nullopt}, {"third", 1000ms}}};
+    status.onTestStarted("first", startTime);
+    EXPECT_FALSE(status.estimatedTimeLeft(startTime).has_value());
+
+    status.onTestFinished("first", true, startTime + 2000ms);
+    EXPECT_EQ(status.estimatedTimeLeft(startTime + 2000ms), 3000ms);
+}
+
+TEST(ProgressStatus, StatusLine)
+{
+    const auto startTime = Clock::now();
+    auto status = lunchtoast::ProgressStatus{{{"first", 1000ms}, {"second", 90s}, {"third", 3600s}}};
+    status.onTestStarted("first", startTime);
+    status.onTestFinished("first", true, startTime + 1000ms);
+    status.onTestStarted("second", startTime + 1000ms);
+    EXPECT_EQ(status.statusLine(startTime + 4000ms), "[ 1 / 3 ] 1 failed | second (3s) | ETA: 1h 1m");
+}
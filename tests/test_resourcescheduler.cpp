@@ -0,0 +1,80 @@
+#include <errors.h>
+#include <resourcescheduler.h>
+#include <gtest/gtest.h>
+
+using ResourceRequirements = std::vector<lunchtoast::ResourceRequirement>;
+
+TEST(ResourceScheduler, ReadRequirements)
+{
+    auto scheduler = lunchtoast::ResourceScheduler{{{"cpu", 4}, {"mem", 8LL * 1024 * 1024 * 1024}}};
+    EXPECT_EQ(
+            scheduler.readRequirements({"port:8080", "cpu:2", "mem:4G", "gpu"}),
+            (ResourceRequirements{
+                    {"cpu", 2},
+                    {"gpu", 1},
+                    {"mem", 4LL * 1024 * 1024 * 1024},
+                    {"port:8080", 1}}));
+    EXPECT_EQ(scheduler.readRequirements({"cpu:16"}), (ResourceRequirements{{"cpu", 4}}));
+    EXPECT_EQ(scheduler.readRequirements({"cpu"}), (ResourceRequirements{{"cpu", 4}}));
+    EXPECT_THROW(scheduler.readRequirements({"cpu:many"}), lunchtoast::TestConfigError);
+    EXPECT_THROW(scheduler.readRequirements({"cpu:0"}), lunchtoast::TestConfigError);
+}
+
+TEST(ResourceScheduler, TasksWithoutResources)
+{
+    auto scheduler = lunchtoast::ResourceScheduler{{}};
+    scheduler.addTask({});
+    scheduler.addTask({});
+    EXPECT_EQ(scheduler.startNextTask(), 0);
+    EXPECT_EQ(scheduler.startNextTask(), 1);
+    EXPECT_EQ(scheduler.startNextTask(), std::nullopt);
+    EXPECT_FALSE(scheduler.hasPendingTasks());
+}
+
+TEST(ResourceScheduler, ExclusiveResource)
+{
+    auto scheduler = lunchtoast::ResourceScheduler{{}};
+    scheduler.addTask({{"port:8080", 1}});
+    scheduler.addTask({{"port:8080", 1}});
+    scheduler.addTask({{"port:8081", 1}});
+    EXPECT_EQ(scheduler.startNextTask(), 0);
+    EXPECT_EQ(scheduler.startNextTask(), 2);
+    EXPECT_EQ(scheduler.startNextTask(), std::nullopt);
+    EXPECT_TRUE(scheduler.hasPendingTasks());
+    scheduler.finishTask(0);
+    EXPECT_EQ(scheduler.startNextTask(), 1);
+    EXPECT_FALSE(scheduler.hasPendingTasks());
+}
+
+TEST(ResourceScheduler, CountedResource)
+{
+    auto scheduler = lunchtoast::ResourceScheduler{{{"cpu", 8}}};
+    scheduler.addTask({{"cpu", 4}});
+    scheduler.addTask({{"cpu", 2}});
+    scheduler.addTask({{"cpu", 2}});
+    scheduler.addTask({{"cpu", 1}});
+    EXPECT_EQ(scheduler.startNextTask(), 0);
+    EXPECT_EQ(scheduler.startNextTask(), 1);
+    EXPECT_EQ(scheduler.startNextTask(), 2);
+    EXPECT_EQ(scheduler.startNextTask(), std::nullopt);
+    scheduler.finishTask(1);
+    EXPECT_EQ(scheduler.startNextTask(), 3);
+}
+
+TEST(ResourceScheduler, WaitingTaskIsNotOvertaken)
+{
+    auto scheduler = lunchtoast::ResourceScheduler{{{"cpu", 8}}};
+    scheduler.addTask({{"cpu", 4}});
+    scheduler.addTask({{"cpu", 8}});
+    scheduler.addTask({{"cpu", 2}});
+    scheduler.addTask({{"port:8080", 1}});
+    EXPECT_EQ(scheduler.startNextTask(), 0);
+    // The free cpus are reserved for the waiting task, tasks using other resources are still started
+    EXPECT_EQ(scheduler.startNextTask(), 3);
+    EXPECT_EQ(scheduler.startNextTask(), std::nullopt);
+    scheduler.finishTask(0);
+    EXPECT_EQ(scheduler.startNextTask(), 1);
+    EXPECT_EQ(scheduler.startNextTask(), std::nullopt);
+    scheduler.finishTask(1);
+    EXPECT_EQ(scheduler.startNextTask(), 2);
+}
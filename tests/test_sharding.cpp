@@ -0,0 +1,35 @@
+#include <sharding.h>
+#include <gtest/gtest.h>
+#include <chrono>
+
+using namespace std::chrono_literals;
+
+TEST(Sharding, SingleShard)
+{
+    auto shards = lunchtoast::distributeOverShards({10ms, 20ms, 30ms}, 1);
+    ASSERT_EQ(shards, (std::vector<int>{0, 0, 0}));
+}
+
+TEST(Sharding, EqualWeights)
+{
+    auto shards = lunchtoast::distributeOverShards({1ms, 1ms, 1ms, 1ms, 1ms}, 2);
+    ASSERT_EQ(shards, (std::vector<int>{0, 1, 0, 1, 0}));
+}
+
+TEST(Sharding, WeightedDistribution)
+{
+    auto shards = lunchtoast::distributeOverShards({10ms, 50ms, 20ms, 30ms, 10ms}, 2);
+    ASSERT_EQ(shards, (std::vector<int>{0, 0, 1, 1, 1}));
+}
+
+TEST(Sharding, MoreShardsThanItems)
+{
+    auto shards = lunchtoast::distributeOverShards({5ms, 10ms}, 4);
+    ASSERT_EQ(shards, (std::vector<int>{1, 0}));
+}
+
+TEST(Sharding, NoItems)
+{
+    auto shards = lunchtoast::distributeOverShards({}, 3);
+    ASSERT_TRUE(shards.empty());
+}
@@ -0,0 +1,47 @@
+#include <tagexpression.h>
+#include <gtest/gtest.h>
+#include <stdexcept>
+
+TEST(TagExpression, SingleTag)
+{
+    const auto expression = lunchtoast::TagExpression{"smoke"};
+    EXPECT_TRUE(expression.isSatisfiedBy({"smoke", "slow"}));
+    EXPECT_FALSE(expression.isSatisfiedBy({"slow"}));
+    EXPECT_FALSE(expression.isSatisfiedBy({}));
+}
+
+TEST(TagExpression, Operators)
+{
+    const auto expression = lunchtoast::TagExpression{"smoke and not slow or linux"};
+    EXPECT_TRUE(expression.isSatisfiedBy({"smoke"}));
+    EXPECT_FALSE(expression.isSatisfiedBy({"smoke", "slow"}));
+    EXPECT_TRUE(expression.isSatisfiedBy({"smoke", "slow", "linux"}));
+    EXPECT_TRUE(expression.isSatisfiedBy({"linux"}));
+    EXPECT_FALSE(expression.isSatisfiedBy({"windows"}));
+}
+
+TEST(TagExpression, Parentheses)
+{
+    const auto expression = lunchtoast::TagExpression{"smoke and not(slow or windows)"};
+    EXPECT_TRUE(expression.isSatisfiedBy({"smoke", "linux"}));
+    EXPECT_FALSE(expression.isSatisfiedBy({"smoke", "windows"}));
+    EXPECT_FALSE(expression.isSatisfiedBy({"smoke", "slow"}));
+    EXPECT_FALSE(expression.isSatisfiedBy({"linux"}));
+}
+
+TEST(TagExpression, DoubleNegation)
+{
+    const auto expression = lunchtoast::TagExpression{"not not smoke"};
+    EXPECT_TRUE(expression.isSatisfiedBy({"smoke"}));
+    EXPECT_FALSE(expression.isSatisfiedBy({}));
+}
+
+TEST(TagExpression, InvalidExpressions)
+{
+    EXPECT_THROW(lunchtoast::TagExpression{""}, std::runtime_error);
+    EXPECT_THROW(lunchtoast::TagExpression{"smoke and"}, std::runtime_error);
+    EXPECT_THROW(lunchtoast::TagExpression{"smoke slow"}, std::runtime_error);
+    EXPECT_THROW(lunchtoast::TagExpression{"(smoke or slow"}, std::runtime_error);
+    EXPECT_THROW(lunchtoast::TagExpression{"smoke)"}, std::runtime_error);
+    EXPECT_THROW(lunchtoast::TagExpression{"not and smoke"}, std::runtime_error);
+}
@@ -0,0 +1,138 @@
+#include <testplan.h>
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+
+namespace fs = std::filesystem;
+
+namespace {
+void writeFile(const fs::path& path, const std::string& content)
+{
+    fs::create_directories(path.parent_path());
+    auto stream = std::ofstream{path, std::ios::binary};
+    stream << content;
+}
+
+class TestPlan : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        dir_ = fs::temp_directory_path() / "lunchtoast_test_testplan";
+        fs::remove_all(dir_);
+        writeFile(dir_ / "test" / "test.toast", "-Launch: echo Hello");
+        writeFile(dir_ / "lunchtoast.cfg", "");
+    }
+
+    void TearDown() override
+    {
+        fs::remove_all(dir_);
+    }
+
+    lunchtoast::TestPlan makePlan()
+    {
+        auto plan = lunchtoast::TestPlan{};
+        plan.collectionOptions = "options";
+        plan.directories[dir_] = lunchtoast::readDirectoryStamp(dir_);
+        plan.directories[dir_ / "test"] = lunchtoast::readDirectoryStamp(dir_ / "test");
+        plan.files[dir_ / "test" / "test.toast"] = lunchtoast::readFileStamp(dir_ / "test" / "test.toast").value();
+        plan.files[dir_ / "lunchtoast.cfg"] = lunchtoast::readFileStamp(dir_ / "lunchtoast.cfg").value();
+        return plan;
+    }
+
+    fs::path dir_;
+};
+} //namespace
+
+TEST_F(TestPlan, WriteAndRead)
+{
+    auto plan = makePlan();
+    auto testCfg = lunchtoast::TestCfg{};
+    testCfg.path = dir_ / "test" / "test.toast";
+    testCfg.isEnabled = false;
+    testCfg.vars = {{"DIR", "test"}, {"text", "Hello\tworld\n\\"}};
+    testCfg.configList = {dir_ / "lunchtoast.cfg"};
+    testCfg.tags = {"smoke", "linux"};
+    testCfg.resources = {"port:8080", "cpu:2"};
+    testCfg.name = "Test";
+    testCfg.description = "Multiline\ndescription";
+    plan.suites["suite"].tests.push_back(testCfg);
+    lunchtoast::writeTestPlan(plan, dir_ / "plan.txt");
+
+    const auto readPlan = lunchtoast::readTestPlan(dir_ / "plan.txt");
+    ASSERT_TRUE(readPlan.has_value());
+    EXPECT_EQ(readPlan->collectionOptions, "options");
+    EXPECT_EQ(readPlan->directories.at(dir_ / "test").entries, "test.toast\n");
+    EXPECT_EQ(readPlan->directories.at(dir_).entries, "lunchtoast.cfg\ntest/\n");
+    EXPECT_EQ(readPlan->files, plan.files);
+    EXPECT_TRUE(readPlan->defaultSuite.tests.empty());
+    const auto& suite = readPlan->suites.at("suite");
+    ASSERT_EQ(suite.tests.size(), 1);
+    EXPECT_EQ(suite.disabledTestsCounter, 1);
+    const auto& readTestCfg = suite.tests.at(0);
+    EXPECT_EQ(readTestCfg.path, testCfg.path);
+    EXPECT_FALSE(readTestCfg.isEnabled);
+    EXPECT_EQ(readTestCfg.vars, testCfg.vars);
+    EXPECT_EQ(readTestCfg.configList, testCfg.configList);
+    EXPECT_EQ(readTestCfg.tags, testCfg.tags);
+    EXPECT_EQ(readTestCfg.resources, testCfg.resources);
+    EXPECT_EQ(readTestCfg.name, testCfg.name);
+    EXPECT_EQ(readTestCfg.description, testCfg.description);
+}
+
+TEST_F(TestPlan, ReadInvalidPlan)
+{
+    EXPECT_FALSE(lunchtoast::readTestPlan(dir_ / "plan.txt").has_value());
+    writeFile(dir_ / "plan.txt", "options\tvalue\nunknown\t1\n");
+    EXPECT_FALSE(lunchtoast::readTestPlan(dir_ / "plan.txt").has_value());
+}
+
+TEST_F(TestPlan, ReadTruncatedPlan)
+{
+    writeFile(dir_ / "plan.txt", "options\tvalue\nend\t1\n");
+    EXPECT_TRUE(lunchtoast::readTestPlan(dir_ / "plan.txt").has_value());
+    writeFile(dir_ / "plan.txt", "options\tvalue\n");
+    EXPECT_FALSE(lunchtoast::readTestPlan(dir_ / "plan.txt").has_value());
+    writeFile(dir_ / "plan.txt", "options\tvalue\nend\t2\n");
+    EXPECT_FALSE(lunchtoast::readTestPlan(dir_ / "plan.txt").has_value());
+}
+
+TEST_F(TestPlan, UpToDate)
+{
+    auto plan = makePlan();
+    EXPECT_EQ(lunchtoast::checkTestPlan(plan, "options"), lunchtoast::TestPlanState::UpToDate);
+    EXPECT_EQ(lunchtoast::checkTestPlan(plan, "other options"), lunchtoast::TestPlanState::Outdated);
+}
+
+TEST_F(TestPlan, ChangedTestFile)
+{
+    auto plan = makePlan();
+    writeFile(dir_ / "test" / "test.toast", "-Launch: echo Hello world");
+    EXPECT_EQ(lunchtoast::checkTestPlan(plan, "options"), lunchtoast::TestPlanState::Outdated);
+}
+
+TEST_F(TestPlan, RemovedConfigFile)
+{
+    auto plan = makePlan();
+    fs::remove(dir_ / "lunchtoast.cfg");
+    EXPECT_EQ(lunchtoast::checkTestPlan(plan, "options"), lunchtoast::TestPlanState::Outdated);
+}
+
+TEST_F(TestPlan, AddedTestDirectory)
+{
+    auto plan = makePlan();
+    fs::create_directories(dir_ / "new_test");
+    EXPECT_EQ(lunchtoast::checkTestPlan(plan, "options"), lunchtoast::TestPlanState::Outdated);
+}
+
+TEST_F(TestPlan, FilesWrittenByTest)
+{
+    auto plan = makePlan();
+    const auto testDirStamp = plan.directories.at(dir_ / "test").stamp;
+    writeFile(dir_ / "test" / "output.txt", "Hello");
+    fs::remove(dir_ / "test" / "output.txt");
+    EXPECT_NE(lunchtoast::readFileStamp(dir_ / "test"), testDirStamp);
+
+    EXPECT_EQ(lunchtoast::checkTestPlan(plan, "options"), lunchtoast::TestPlanState::UpdatedStamps);
+    EXPECT_EQ(plan.directories.at(dir_ / "test").stamp, lunchtoast::readFileStamp(dir_ / "test"));
+    EXPECT_EQ(lunchtoast::checkTestPlan(plan, "options"), lunchtoast::TestPlanState::UpToDate);
+}
@@ -0,0 +1,134 @@
+#include <textdiff.h>
+#include <gtest/gtest.h>
+#include <string>
+
+using namespace lunchtoast;
+
+TEST(TextDiff, EqualTexts)
+{
+    EXPECT_EQ(makeUnifiedDiff("Hello\nworld", "Hello\nworld"), "");
+}
+
+TEST(TextDiff, ChangedLine)
+{
+    EXPECT_EQ(
+            makeUnifiedDiff("Hello\nworld\n!", "Hello\nuniverse\n!"),
+            "--- expected\n"
+            "+++ actual\n"
+            "@@ -1,3 +1,3 @@\n"
+            " Hello\n"
+            "-world\n"
+            "+universe\n"
+            " !\n");
+}
+
+TEST(TextDiff, InsertedAndDeletedLines)
+{
+    EXPECT_EQ(
+            makeUnifiedDiff("a\nb\nc\nd", "a\nc\nd\ne"),
+            "--- expected\n"
+            "+++ actual\n"
+            "@@ -1,4 +1,4 @@\n"
+            " a\n"
+            "-b\n"
+            " c\n"
+            " d\n"
+            "+e\n");
+}
+
+TEST(TextDiff, EmptyExpectedText)
+{
+    EXPECT_EQ(
+            makeUnifiedDiff("", "a\nb"),
+            "--- expected\n"
+            "+++ actual\n"
+            "@@ -0,0 +1,2 @@\n"
+            "+a\n"
+            "+b\n");
+}
+
+TEST(TextDiff, SeparateHunks)
+{
+    auto expected = std::string{};
+    auto actual = std::string{};
+    for (auto i = 1; i <= 20; ++i) {
+        expected += std::to_string(i) + "\n";
+        actual += (i == 2 || i == 18 ? "x" : std::to_string(i)) + "\n";
+    }
+    EXPECT_EQ(
+            makeUnifiedDiff(expected, actual, 1),
+            "--- expected\n"
+            "+++ actual\n"
+            "@@ -1,3 +1,3 @@\n"
+            " 1\n"
+            "-2\n"
+            "+x\n"
+            " 3\n"
+            "@@ -17,3 +17,3 @@\n"
+            " 17\n"
+            "-18\n"
+            "+x\n"
+            " 19\n");
+}
+
+TEST(TextDiff, FirstDifferenceWhenLimitIsExceeded)
+{
+    EXPECT_EQ(
+            makeUnifiedDiff("a\nb\nc\nd", "a\nx\ny\nz", 3, {.maxChangedLines = 2}),
+            "Texts are too different to build a diff, the first difference is at line 2:\n"
+            "-b\n"
+            "+x\n");
+}
+
+TEST(TextMismatchReport, SmallTexts)
+{
+    EXPECT_EQ(
+            makeTextMismatchReport("Output", "Hello\nuniverse", "Hello\nworld"),
+            "-Output:\n"
+            "Hello\n"
+            "universe\n"
+            "---\n"
+            "-Expected output:\n"
+            "Hello\n"
+            "world\n"
+            "---\n"
+            "-Output diff:\n"
+            "--- expected\n"
+            "+++ actual\n"
+            "@@ -1,2 +1,2 @@\n"
+            " Hello\n"
+            "-world\n"
+            "+universe\n"
+            "---\n");
+}
+
+TEST(TextMismatchReport, TrailingLineBreak)
+{
+    EXPECT_EQ(
+            makeTextMismatchReport("Content", "Hello\n", "Hello"),
+            "-Content:\n"
+            "Hello\n"
+            "\n"
+            "---\n"
+            "-Expected content:\n"
+            "Hello\n"
+            "---\n"
+            "-Content diff:\n"
+            "Texts differ only by line breaks at the end\n"
+            "---\n");
+}
+
+TEST(TextMismatchReport, LargeTexts)
+{
+    const auto expected = std::string(70000, 'a') + "\nb";
+    const auto actual = std::string(70000, 'a') + "\nc";
+    const auto report = makeTextMismatchReport("Output", actual, expected);
+    EXPECT_EQ(
+            report.substr(0, report.find("@@")),
+            "-Output: 70002 bytes, omitted\n"
+            "-Expected output: 70002 bytes, omitted\n"
+            "-Output diff:\n"
+            "--- expected\n"
+            "+++ actual\n");
+    EXPECT_TRUE(report.ends_with("@@ -1,2 +1,2 @@\n " + std::string(70000, 'a') + "\n-b\n+c\n---\n"));
+}
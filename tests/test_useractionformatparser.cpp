@@ -54,6 +54,28 @@ TEST(UserActionFormatParser, MultipleParams3)
     EXPECT_EQ(userActionFormat.paramsOrder, (std::vector{3, 1, 2}));
 }
 
+TEST(UserActionFormatParser, LiteralPrefix)
+{
+    EXPECT_EQ(makeUserActionFormat("Hello world %1").literalPrefix, "Hello world");
+    EXPECT_EQ(makeUserActionFormat("Hello%1world").literalPrefix, "Hello");
+    EXPECT_EQ(makeUserActionFormat("Hello world").literalPrefix, "Hello world");
+}
+
+TEST(UserActionFormatParser, EmptyLiteralPrefix)
+{
+    EXPECT_EQ(makeUserActionFormat("%1 Hello world").literalPrefix, "");
+    EXPECT_EQ(makeUserActionFormat("%3Hello%1 world %2").literalPrefix, "");
+}
+
+TEST(UserActionFormatParser, LiteralPrefixWithRegexChars)
+{
+    EXPECT_EQ(makeUserActionFormat("Hello.world %1").literalPrefix, "Hello");
+    EXPECT_EQ(makeUserActionFormat("Hellos? world %1").literalPrefix, "Hello");
+    EXPECT_EQ(makeUserActionFormat("Hello (big )?world %1").literalPrefix, "Hello ");
+    EXPECT_EQ(makeUserActionFormat("Hello|Goodbye world %1").literalPrefix, "");
+    EXPECT_EQ(makeUserActionFormat("Hello %1 (world|universe)").literalPrefix, "");
+}
+
 TEST(UserActionFormatParser, ErrorSameParameters)
 {
     assert_exception<lunchtoast::ActionFormatError>(
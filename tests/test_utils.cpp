@@ -3,6 +3,8 @@
 #include <utils.h>
 #include <fmt/format.h>
 #include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
 #include <functional>
 #include <sstream>
 #include <chrono>
@@ -101,6 +103,39 @@ TEST(Utils, SplitCommandUnclosedString2)
             });
 }
 
+TEST(Utils, SplitPipeline)
+{
+    auto stages = lunchtoast::splitPipeline("producer -n 10 | filter -e \"a|b\" |consumer '|'");
+    ASSERT_EQ(stages, (std::vector<std::string>{"producer -n 10", "filter -e \"a|b\"", "consumer '|'"}));
+}
+
+TEST(Utils, SplitPipelineSingleStage)
+{
+    auto stages = lunchtoast::splitPipeline("command -param");
+    ASSERT_EQ(stages, (std::vector<std::string>{"command -param"}));
+}
+
+TEST(Utils, SplitPipelineEmptyStage)
+{
+    auto stages = lunchtoast::splitPipeline("producer || consumer");
+    ASSERT_EQ(stages, (std::vector<std::string>{"producer", "", "consumer"}));
+}
+
+TEST(Utils, SplitPipelineUnclosedString)
+{
+    assert_exception<lunchtoast::TestConfigError>(
+            []
+            {
+                [[maybe_unused]] auto stages = lunchtoast::splitPipeline("producer | filter -e \"a|b");
+            },
+            [](const auto& e)
+            {
+                ASSERT_EQ(
+                        std::string{e.what()},
+                        "Pipeline 'producer | filter -e \"a|b' has an unclosed quotation mark");
+            });
+}
+
 TEST(Utils, ReadInputParams)
 {
     const auto sections = lunchtoast::readInputParamSections(R"(
@@ -187,4 +222,53 @@ TEST(Utils, ReadTime)
     EXPECT_FALSE(lunchtoast::readTime("foo seconds"));
     EXPECT_FALSE(lunchtoast::readTime("foo"));
     EXPECT_FALSE(lunchtoast::readTime("-1 sec"));
-}
\ No newline at end of file
+}
+TEST(Utils, NormalizeLineEndings)
+{
+    EXPECT_EQ(lunchtoast::normalizeLineEndings(""), "");
+    EXPECT_EQ(lunchtoast::normalizeLineEndings("Hello\nworld\n"), "Hello\nworld\n");
+    EXPECT_EQ(lunchtoast::normalizeLineEndings("Hello\r\nworld\r\n"), "Hello\nworld\n");
+    EXPECT_EQ(lunchtoast::normalizeLineEndings("Hello\rworld\r"), "Hello\nworld\n");
+    EXPECT_EQ(lunchtoast::normalizeLineEndings("\r\r\n\n\r"), "\n\n\n\n");
+    EXPECT_EQ(lunchtoast::normalizeLineEndings("a\r\nb\rc\nd"), "a\nb\nc\nd");
+}
+
+TEST(Utils, ReadDataSize)
+{
+    EXPECT_EQ(lunchtoast::readDataSize("100"), 100);
+    EXPECT_EQ(lunchtoast::readDataSize("100 bytes"), 100);
+    EXPECT_EQ(lunchtoast::readDataSize("100B"), 100);
+    EXPECT_EQ(lunchtoast::readDataSize("2 KB"), 2 * 1024);
+    EXPECT_EQ(lunchtoast::readDataSize("2kb"), 2 * 1024);
+    EXPECT_EQ(lunchtoast::readDataSize(" 100 MB "), 100 * 1024 * 1024);
+    EXPECT_EQ(lunchtoast::readDataSize("4 GB"), std::int64_t{4} * 1024 * 1024 * 1024);
+    EXPECT_EQ(lunchtoast::readDataSize("512M"), 512 * 1024 * 1024);
+    EXPECT_EQ(lunchtoast::readDataSize("4G"), std::int64_t{4} * 1024 * 1024 * 1024);
+
+    EXPECT_FALSE(lunchtoast::readDataSize("MB"));
+    EXPECT_FALSE(lunchtoast::readDataSize("100 TB"));
+    EXPECT_FALSE(lunchtoast::readDataSize("-1 MB"));
+}
+
+TEST(Utils, ReadFile)
+{
+    const auto filePath = std::filesystem::temp_directory_path() / "lunchtoast_test_read_file.txt";
+    // The content is larger than the chunk read at once
+    auto content = std::string{};
+    for (auto i = 0; i < 20000; ++i)
+        content += fmt::format("line {}\n", i);
+    {
+        auto stream = std::ofstream{filePath, std::ios::binary};
+        stream << content;
+    }
+    EXPECT_EQ(lunchtoast::readFile(filePath), content);
+    std::filesystem::remove(filePath);
+}
+
+#ifdef __linux__
+TEST(Utils, ReadFileWithZeroReportedSize)
+{
+    ASSERT_EQ(std::filesystem::file_size("/proc/self/status"), 0);
+    EXPECT_TRUE(lunchtoast::readFile("/proc/self/status").starts_with("Name:"));
+}
+#endif